@@ -7,6 +7,7 @@ CONFIG -= app_bundle
 
 DEFINES += JJSON17_PARSE
 DEFINES += PERFOMANCE_TEST
+#DEFINES += JJSON17_INSTRUMENT
 
 TEMPLATE = app
 
@@ -14,6 +15,7 @@ SOURCES +=  tst_qjsoncompatibility.cpp \
     ../jjson17/jjson17.cpp
 
 HEADERS += \
+    instrument.h \
     ../jjson17/jjson17.h
 
 INCLUDEPATH += ../jjson17
@@ -0,0 +1,19 @@
+QT -= gui core
+
+CONFIG += c++17
+CONFIG += console warn_on release
+CONFIG -= qt app_bundle
+
+DEFINES += JJSON17_PARSE
+
+TEMPLATE = app
+TARGET = JJSON17_bench
+
+SOURCES +=  bench_jjson17.cpp \
+    ../jjson17/jjson17.cpp
+
+HEADERS += \
+    ../jjson17/jjson17.h
+
+INCLUDEPATH += ../jjson17
+
@@ -0,0 +1,474 @@
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "jjson17.h"
+
+//Воспроизводимый бенчмарк jjson17: синтетические корпуса с фиксированным seed,
+//фазы build/serialize/parse/destroy измеряются отдельно, результат пишется в JSON.
+//Запуск: JJSON17_bench [--reps N] [--scale K] [--out file.json]
+//Код возврата: 0, 1 при неверных аргументах, 2 если результаты хотя бы одного замера не сошлись.
+
+//....... учёт выделений памяти .......
+static std::atomic<uint64_t> g_allocs{0};
+static std::atomic<uint64_t> g_allocBytes{0};
+
+void* operator new(std::size_t n)
+{
+    g_allocs.fetch_add(1,std::memory_order_relaxed);
+    g_allocBytes.fetch_add(n,std::memory_order_relaxed);
+    if(void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+namespace json = jjson17;
+using namespace std::chrono;
+
+struct Corpus {
+    std::string                 name;
+    std::function<json::Value()> build;
+};
+
+//....... корпуса .......
+json::Value wideObject(int scale)
+{
+    std::mt19937 rnd(17);
+    json::Object obj;
+    const int N = 20000*scale;
+    for(int i = 0; i < N; ++i) {
+        std::string key = "key_" + std::to_string(rnd()) + "_" + std::to_string(i);
+        if(i%3 == 0)      obj.insert({key,int64_t(rnd()%100000)});
+        else if(i%3 == 1) obj.insert({key,"value " + std::to_string(i)});
+        else              obj.insert({key,i%2 == 0});
+    }
+    return obj;
+}
+
+json::Value deepNesting(int scale)
+{
+    const int DEPTH = 100;
+    json::Array root;
+    for(int n = 0; n < 200*scale; ++n) {
+        json::Value node = json::Array{n,"leaf"};
+        //элементы initializer_list копируются: поддерево переносится в уже созданный уровень
+        for(int d = 0; d < DEPTH; ++d) {
+            if(d%2) {
+                json::Object level{{"level",d}};
+                level.insert({"child",std::move(node)});
+                node = std::move(level);
+            } else {
+                json::Array level{d};
+                level.push_back(std::move(node));
+                node = std::move(level);
+            }
+        }
+        root.push_back(std::move(node));
+    }
+    return root;
+}
+
+json::Value numericArrays(int scale)
+{
+    std::mt19937 rnd(42);
+    std::uniform_real_distribution<double> real(-1e6,1e6);
+    std::uniform_int_distribution<int64_t> integer(-1000000000,1000000000);
+    json::Array root;
+    for(int n = 0; n < 200*scale; ++n) {
+        json::Array row;
+        row.reserve(1000);
+        for(int i = 0; i < 1000; ++i) {
+            if(i%2) row.push_back(real(rnd));
+            else    row.push_back(integer(rnd));
+        }
+        root.push_back(std::move(row));
+    }
+    return root;
+}
+
+json::Value unicodeEscapes(int scale)
+{
+    const std::vector<std::string> pieces = {
+        "Русский текст", "正在發展這個協", " نوعية واحدة م", "기술적 설명", "domésticas más",
+        u8"∑", "\"quoted\"", "back\\slash", "line\nbreak", "tab\there", "\r\f\b", "plain ascii"
+    };
+    std::mt19937 rnd(7);
+    json::Array root;
+    for(int n = 0; n < 20000*scale; ++n) {
+        std::string s;
+        for(int i = 0; i < 6; ++i)
+            s += pieces[rnd()%pieces.size()];
+        root.push_back(std::move(s));
+    }
+    return root;
+}
+
+//тот же размер и форма, что у unicodeEscapes, но только ASCII без escape: точка отсчёта для unicode/escape-строк
+json::Value asciiStrings(int scale)
+{
+    const std::vector<std::string> pieces = {
+        "Russkiy tekst", "zhengzai fazhan", " nawiya wahida m", "gisuljeok", "domesticas mas",
+        "sum", "quoted text", "back slash", "line break", "tab here", "cr ff bs", "plain ascii"
+    };
+    std::mt19937 rnd(7);
+    json::Array root;
+    for(int n = 0; n < 20000*scale; ++n) {
+        std::string s;
+        for(int i = 0; i < 6; ++i)
+            s += pieces[rnd()%pieces.size()];
+        root.push_back(std::move(s));
+    }
+    return root;
+}
+
+json::Value records(int scale)
+{
+    std::mt19937 rnd(1);
+    const std::vector<std::string> positions = {"sniper","officer","mascot","engineer","medic"};
+    json::Array root;
+    for(int n = 0; n < 10000*scale; ++n) {
+        json::Array subordinates;
+        const unsigned count = rnd()%4;
+        for(unsigned i = 0; i < count; ++i)
+            subordinates.push_back("staff_" + std::to_string(rnd()%1000));
+        json::Object rec {
+            {"name"     ,"staff_" + std::to_string(n)},
+            {"position" ,positions[rnd()%positions.size()]},
+            {"salary"   ,(rnd()%300000)/100.},
+            {"age"      ,int64_t(18 + rnd()%50)},
+            {"newbi"    ,rnd()%2 == 0},
+            {"address"  ,json::Object{{"city","Moscow"},{"zip",int64_t(100000 + rnd()%1000)},{"geo",json::Array{55.75,37.61}}}}
+        };
+        rec.insert({"subordinates",subordinates.empty() ? json::Value(nullptr) : json::Value(std::move(subordinates))});
+        root.push_back(std::move(rec));
+    }
+    return root;
+}
+
+//....... измерения .......
+//число расхождений при проверке результатов: бенчмарк с расхождениями завершается с ненулевым кодом
+int g_mismatches{0};
+
+void mismatch(const std::string& what)
+{
+    std::cerr << what << '\n';
+    g_mismatches++;
+}
+
+struct Stats {
+    std::vector<double> ns;
+    uint64_t allocs{0};
+    uint64_t allocBytes{0};
+};
+
+std::string write(const json::Value& v)
+{
+    std::stringstream ss;
+                      ss.precision(12);
+    if(std::holds_alternative<json::Object>(v))
+         ss << std::get<json::Object>(v);
+    else ss << std::get<json::Array>(v);
+    return ss.str();
+}
+
+size_t countValues(const json::Value& v)
+{
+    size_t n = 1;
+    if(std::holds_alternative<json::Object>(v))
+        for(const auto& [k,e] : std::get<json::Object>(v))
+            n += countValues(e);
+    else if(std::holds_alternative<json::Array>(v))
+        for(const auto& e : std::get<json::Array>(v))
+            n += countValues(e);
+    return n;
+}
+
+double percentile(std::vector<double> samples, double p)
+{
+    std::sort(samples.begin(),samples.end());
+    size_t rank = size_t(p/100.*(samples.size()-1) + 0.5);
+    return samples[rank];
+}
+
+template <typename F>
+void measure(Stats& stats, F&& f)
+{
+    auto allocs = g_allocs.load();
+    auto bytes  = g_allocBytes.load();
+    auto before = steady_clock::now();
+    f();
+    auto after  = steady_clock::now();
+    //счётчики снимаются до push_back: рост вектора замеров не относится к фазе
+    stats.allocs     += g_allocs.load() - allocs;
+    stats.allocBytes += g_allocBytes.load() - bytes;
+    stats.ns.push_back(double(duration_cast<nanoseconds>(after - before).count()));
+}
+
+json::Object report(const std::string& corpus, const std::string& phase, const Stats& stats, size_t bytes, size_t values)
+{
+    const auto reps = stats.ns.size();
+    double p50 = percentile(stats.ns,50);
+    json::Object r {
+        {"corpus"     ,corpus},
+        {"phase"      ,phase},
+        {"reps"       ,int64_t(reps)},
+        {"bytes"      ,int64_t(bytes)},
+        {"values"     ,int64_t(values)},
+        {"min_ns"     ,percentile(stats.ns,0)},
+        {"p50_ns"     ,p50},
+        {"p90_ns"     ,percentile(stats.ns,90)},
+        {"p99_ns"     ,percentile(stats.ns,99)},
+        {"max_ns"     ,percentile(stats.ns,100)},
+        {"mb_per_s"   ,p50 > 0 ? bytes/1048576./(p50*1e-9) : 0.},
+        {"allocs"     ,int64_t(stats.allocs/reps)},
+        {"alloc_bytes",int64_t(stats.allocBytes/reps)},
+        {"alloc_bytes_per_value",double(stats.allocBytes)/reps/values}
+    };
+    std::cerr << corpus << '\t' << phase << "\tp50 " << p50/1e6 << " ms\t"
+              << std::get<double>(r["mb_per_s"]) << " MB/s\tallocs " << stats.allocs/reps << '\n';
+    return r;
+}
+
+json::Array runCorpus(const Corpus& corpus, int reps)
+{
+    Stats build, serialize, parse, destroy;
+    std::string text;
+    size_t values{0};
+    for(int rep = 0; rep < reps; ++rep) {
+        json::Value doc;
+        measure(build,     [&]{ doc = corpus.build(); });
+        if(rep == 0) values = countValues(doc);
+        measure(serialize, [&]{ text = write(doc); });
+        {
+            std::istringstream iss(text);
+            json::Value parsed;
+            measure(parse, [&]{ parsed = json::parse(iss); });
+            if(write(parsed) != text)
+                mismatch(corpus.name + ": parse/serialize round trip differs");
+        }
+        measure(destroy,   [&]{ json::Value dead = std::move(doc); });
+    }
+    return json::Array {
+        report(corpus.name,"build"    ,build    ,text.size(),values),
+        report(corpus.name,"serialize",serialize,text.size(),values),
+        report(corpus.name,"parse"    ,parse    ,text.size(),values),
+        report(corpus.name,"destroy"  ,destroy  ,text.size(),values)
+    };
+}
+
+//....... структуры <-> JSON через промежуточный DOM .......
+//так сейчас пишутся конвертеры в тестах (convert для Test_Staff, asJsonObject, MixLatinNum)
+struct Staff {
+    std::string              name;
+    std::string              position;
+    std::vector<std::string> subordinates;
+    double                   salary;
+    unsigned char            age;
+    bool                     newbi;
+};
+
+json::Object toJson(const Staff& t)
+{
+    json::Object r {
+        {"name"    ,t.name    },
+        {"position",t.position},
+        {"salary"  ,t.salary  },
+        {"age"     ,t.age     },
+        {"newbi"   ,t.newbi   }
+    };
+    if(t.subordinates.empty())
+        r.insert({"subordinates",nullptr});
+    else {
+        json::Array lst;
+        for(const auto& s : t.subordinates)
+            lst.push_back(s);
+        r.insert({"subordinates",std::move(lst)});
+    }
+    return r;
+}
+
+Staff fromJson(const json::Object& obj)
+{
+    Staff t;
+    t.name     = std::get<std::string>(obj.at("name"));
+    t.position = std::get<std::string>(obj.at("position"));
+    t.salary   = obj.at("salary");
+    t.age      = static_cast<unsigned char>(std::get<int64_t>(obj.at("age")));
+    t.newbi    = std::get<bool>(obj.at("newbi"));
+    if(const auto& subs = obj.at("subordinates"); std::holds_alternative<json::Array>(subs))
+        for(const auto& s : std::get<json::Array>(subs))
+            t.subordinates.push_back(std::get<std::string>(s));
+    return t;
+}
+
+json::Array runStructs(int scale, int reps)
+{
+    std::mt19937 rnd(3);
+    const std::vector<std::string> positions = {"sniper","officer","mascot","engineer","medic"};
+    std::vector<Staff> staff(size_t(20000)*scale);
+    for(size_t n = 0; n < staff.size(); ++n) {
+        auto& t = staff[n];
+        t.name     = "staff_" + std::to_string(n);
+        t.position = positions[rnd()%positions.size()];
+        t.salary   = (rnd()%300000)/100.;
+        t.age      = static_cast<unsigned char>(18 + rnd()%50);
+        t.newbi    = rnd()%2 == 0;
+        const unsigned count = rnd()%4;
+        for(unsigned i = 0; i < count; ++i)
+            t.subordinates.push_back("staff_" + std::to_string(rnd()%1000));
+    }
+
+    Stats serialize, parse;
+    std::string text;
+    for(int rep = 0; rep < reps; ++rep) {
+        measure(serialize, [&]{
+            std::stringstream ss;
+                              ss.precision(12);
+                              ss << "[\n";
+            for(size_t n = 0; n < staff.size(); ++n) {
+                if(n) ss << ",\n";
+                ss << toJson(staff[n]);
+            }
+                              ss << "\n]";
+            text = ss.str();
+        });
+        std::vector<Staff> back;
+        back.reserve(staff.size());
+        measure(parse, [&]{
+            std::istringstream iss(text);
+            auto doc = json::parse(iss);
+            for(const auto& v : std::get<json::Array>(doc))
+                back.push_back(fromJson(std::get<json::Object>(v)));
+        });
+        if(back.size() != staff.size() || back.empty() || back.back().name != staff.back().name)
+            mismatch("staff_structs: round trip differs");
+    }
+    return json::Array {
+        report("staff_structs","serialize_via_dom",serialize,text.size(),staff.size()),
+        report("staff_structs","parse_via_dom"    ,parse    ,text.size(),staff.size())
+    };
+}
+
+//....... вставка и поиск в широком объекте .......
+//сравнение Object с хеш-таблицей std::unordered_map на тех же ключах (имена файлов, как в /usr/bin)
+json::Array runWideLookup(int scale, int reps)
+{
+    std::mt19937 rnd(11);
+    const char* suffixes[] = {"", "-config", ".so", "-daemon", "2", "3.11", "_helper"};
+    std::vector<std::string> keys;
+    std::vector<std::string> missing;
+    size_t keyBytes{0};
+    for(int i = 0; i < 10000*scale; ++i) {
+        std::string k;
+        for(int c = 0, len = 3 + int(rnd()%8); c < len; ++c)
+            k += char('a' + rnd()%26);
+        k += suffixes[rnd()%7];
+        k += std::to_string(i);
+        keyBytes += k.size();
+        missing.push_back(k + "~");
+        keys.push_back(std::move(k));
+    }
+
+    Stats objInsert, objHit, objMiss, hashInsert, hashHit, hashMiss;
+    size_t found{0};
+    for(int rep = 0; rep < reps; ++rep) {
+        json::Object obj;
+        measure(objInsert, [&]{ for(const auto& k : keys) obj.insert({k,int64_t(k.size())}); });
+        measure(objHit,    [&]{ for(const auto& k : keys) found += obj.find(k) != obj.end(); });
+        measure(objMiss,   [&]{ for(const auto& k : missing) found += obj.find(k) != obj.end(); });
+
+        std::unordered_map<std::string,json::Value> hash;
+        measure(hashInsert,[&]{ for(const auto& k : keys) hash.insert({k,int64_t(k.size())}); });
+        measure(hashHit,   [&]{ for(const auto& k : keys) found += hash.find(k) != hash.end(); });
+        measure(hashMiss,  [&]{ for(const auto& k : missing) found += hash.find(k) != hash.end(); });
+    }
+    if(found != 2*keys.size()*size_t(reps))
+        mismatch("wide_lookup: unexpected lookup results");
+    return json::Array {
+        report("wide_lookup","object_insert"       ,objInsert ,keyBytes,keys.size()),
+        report("wide_lookup","object_find_hit"     ,objHit    ,keyBytes,keys.size()),
+        report("wide_lookup","object_find_miss"    ,objMiss   ,keyBytes,keys.size()),
+        report("wide_lookup","unordered_map_insert",hashInsert,keyBytes,keys.size()),
+        report("wide_lookup","unordered_map_hit"   ,hashHit   ,keyBytes,keys.size()),
+        report("wide_lookup","unordered_map_miss"  ,hashMiss  ,keyBytes,keys.size())
+    };
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    int reps  = 10;
+    int scale = 1;
+    std::string out;
+    for(int i = 1; i < argc; ++i) {
+        if(!std::strcmp(argv[i],"--reps") && i+1 < argc)       reps  = std::max(1,std::atoi(argv[++i]));
+        else if(!std::strcmp(argv[i],"--scale") && i+1 < argc) scale = std::max(1,std::atoi(argv[++i]));
+        else if(!std::strcmp(argv[i],"--out") && i+1 < argc)   out   = argv[++i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [--reps N] [--scale K] [--out file.json]\n";
+            return 1;
+        }
+    }
+
+    const std::vector<Corpus> corpora = {
+        {"wide_object"    ,[scale]{ return wideObject(scale);     }},
+        {"deep_nesting"   ,[scale]{ return deepNesting(scale);    }},
+        {"numeric_arrays" ,[scale]{ return numericArrays(scale);  }},
+        {"unicode_escapes",[scale]{ return unicodeEscapes(scale); }},
+        {"ascii_strings"  ,[scale]{ return asciiStrings(scale);   }},
+        {"records"        ,[scale]{ return records(scale);        }}
+    };
+
+    json::Array results;
+    for(const auto& c : corpora)
+        for(auto& r : runCorpus(c,reps))
+            results.push_back(r);
+    for(auto& r : runStructs(scale,reps))
+        results.push_back(r);
+    for(auto& r : runWideLookup(scale,reps))
+        results.push_back(r);
+
+    //размеры узлов DOM: от них зависит, сколько памяти занимают массивы чисел
+    json::Object layout {
+        {"sizeof_value" ,int64_t(sizeof(json::Value))},
+        {"sizeof_object",int64_t(sizeof(json::Object))},
+        {"sizeof_array" ,int64_t(sizeof(json::Array))},
+        {"sizeof_string",int64_t(sizeof(std::string))}
+    };
+    std::cerr << "sizeof(Value) " << sizeof(json::Value) << ", sizeof(Object) " << sizeof(json::Object)
+              << ", sizeof(Array) " << sizeof(json::Array) << ", sizeof(std::string) " << sizeof(std::string) << '\n';
+
+    json::Object root {
+        {"reps"   ,reps},
+        {"scale"  ,scale}
+    };
+    //элементы initializer_list копируются, поэтому поддеревья вставляются перемещением
+    root.insert({"layout" ,std::move(layout)});
+    root.insert({"results",std::move(results)});
+    if(out.empty()) {
+        std::cout.precision(12);
+        std::cout << root << std::endl;
+    } else {
+        std::ofstream ofs;
+                      ofs.precision(12);
+                      ofs.open(out);
+                      ofs << root;
+                      ofs.close();
+    }
+    return g_mismatches ? 2 : 0;
+}
@@ -0,0 +1,125 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+//Необязательная инструментовка тестов: счётчики выделений памяти и именованные таймеры.
+//Включается через DEFINES += JJSON17_INSTRUMENT, иначе макросы раскрываются в пустоту.
+//Выделения считаются в thread_local счётчиках (operator new заменяется в tst_qjsoncompatibility.cpp),
+//поэтому область видит только выделения своего потока; итоги по меткам суммируются в общий реестр.
+//Живые байты и их максимум общие для процесса.
+
+#ifdef JJSON17_INSTRUMENT
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace instrument {
+
+//счётчики выделений текущего потока, их увеличивает operator new из tst_qjsoncompatibility.cpp
+inline thread_local uint64_t threadAllocs{0};
+inline thread_local uint64_t threadAllocBytes{0};
+
+//живые байты operator new и их максимум; общие для процесса, т.к. память освобождает не обязательно выделивший поток
+inline std::atomic<int64_t> liveBytes{0};
+inline std::atomic<int64_t> peakLiveBytes{0};
+
+inline void addLiveBytes(int64_t n)
+{
+    int64_t live = liveBytes.fetch_add(n,std::memory_order_relaxed) + n;
+    int64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+    while(live > peak && !peakLiveBytes.compare_exchange_weak(peak,live,std::memory_order_relaxed)) {}
+}
+//начать замер максимума заново с текущего уровня
+inline void resetPeakLiveBytes() { peakLiveBytes = liveBytes.load(); }
+
+struct Totals {
+    uint64_t calls{0};
+    uint64_t ns{0};
+    uint64_t allocs{0};
+    uint64_t allocBytes{0};
+};
+
+inline std::mutex& registryMutex()
+{
+    static std::mutex m;
+    return m;
+}
+inline std::map<std::string,Totals>& registry()
+{
+    static std::map<std::string,Totals> r;
+    return r;
+}
+
+class Scope
+{
+public:
+    explicit Scope(const char* label)
+        : label_(label),
+          allocs_(threadAllocs),
+          allocBytes_(threadAllocBytes),
+          start_(std::chrono::steady_clock::now())
+    {}
+    ~Scope() { stop(); }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    void stop()
+    {
+        if(stopped_) return;
+        stopped_ = true;
+        auto ns     = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        auto allocs = threadAllocs - allocs_;
+        auto bytes  = threadAllocBytes - allocBytes_;
+        std::lock_guard<std::mutex> lock(registryMutex());
+        auto& t = registry()[label_];
+        t.calls++;
+        t.ns         += uint64_t(ns);
+        t.allocs     += allocs;
+        t.allocBytes += bytes;
+    }
+private:
+    const char* label_;
+    uint64_t    allocs_;
+    uint64_t    allocBytes_;
+    std::chrono::steady_clock::time_point start_;
+    bool        stopped_{false};
+};
+
+//таблица по меткам: вызовы, время, выделения
+inline void report(std::ostream& os)
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    os << std::left << std::setw(36) << "label" << std::right
+       << std::setw(8) << "calls" << std::setw(12) << "ms" << std::setw(14) << "allocs" << std::setw(16) << "alloc bytes" << '\n';
+    for(const auto& [label,t] : registry())
+        os << std::left << std::setw(36) << label << std::right
+           << std::setw(8) << t.calls << std::setw(12) << t.ns/1000000 << std::setw(14) << t.allocs << std::setw(16) << t.allocBytes << '\n';
+}
+inline void reset()
+{
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().clear();
+}
+
+}
+
+#define JJSON17_SCOPE_CAT_(a,b)        a##b
+#define JJSON17_SCOPE_CAT(a,b)         JJSON17_SCOPE_CAT_(a,b)
+#define JJSON17_SCOPE(label)           instrument::Scope JJSON17_SCOPE_CAT(instrumentScope_,__LINE__)(label)
+#define JJSON17_SCOPE_BEGIN(var,label) instrument::Scope var(label)
+#define JJSON17_SCOPE_END(var)         var.stop()
+
+#else
+
+#define JJSON17_SCOPE(label)
+#define JJSON17_SCOPE_BEGIN(var,label)
+#define JJSON17_SCOPE_END(var)
+
+#endif
+
+#endif // INSTRUMENT_H
@@ -2,13 +2,53 @@
 
 #include <QDir>
 #include <QJsonDocument>
+#include <QCborValue>
 
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <filesystem>
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <new>
+
+#if defined(Q_OS_LINUX) || defined(__linux)
+#include <malloc.h>
+#endif
 
 #include "jjson17.h"
+#include "instrument.h"
+
+#ifdef JJSON17_INSTRUMENT
+//раскладка блоков не меняется: память из exe может освобождать чужой модуль (например, ~QDebug в Qt Core на Windows)
+#ifdef __GLIBC__
+#define JJSON17_LIVE_BYTES      //живые байты по malloc_usable_size
+#endif
+void* operator new(std::size_t n)
+{
+    instrument::threadAllocs++;
+    instrument::threadAllocBytes += n;
+    if(void* p = std::malloc(n ? n : 1)) {
+#ifdef JJSON17_LIVE_BYTES
+        instrument::addLiveBytes(int64_t(malloc_usable_size(p)));
+#endif
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept
+{
+#ifdef JJSON17_LIVE_BYTES
+    if(p) instrument::addLiveBytes(-int64_t(malloc_usable_size(p)));
+#endif
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+#endif
 
 class QJsonCompatibility : public QObject
 {
@@ -19,6 +59,7 @@ public:
     ~QJsonCompatibility();
 
 private slots:
+    void cleanupTestCase();
     void validation_self_test();
     void test_1_latin();
     void test_2_reals();
@@ -29,8 +70,17 @@ private slots:
     void test_7_incaps_structures_1();
     void test_8_to_string();
     void test_9_implicit_cast();
+    void test_10_object_order();
+    void test_11_build_allocations();
     void perf_1_dirscan();
     void perf_2_dirscan();
+    void perf_3_parse_dirscan();
+    void perf_4_parse_large();
+    void perf_5_dirscan_streaming();
+    void perf_6_dirscan_parallel_write();
+    void perf_7_parse_read_fields();
+    void perf_8_dirscan_binary();
+    void perf_9_fanout_copy();
 
 
     void parse_1_numbers();
@@ -38,6 +88,13 @@ private slots:
     void parse_3_latin();
     void parse_3_latin_self();
     void parse_4_mix_latin_nums();
+    void parse_5_roundtrip_self();
+    void parse_6_reals_exact();
+    void parse_7_numeric_arrays();
+    void parse_8_rfc6901_keys();
+    void parse_9_shape_errors();
+    void parse_10_chunked_input();
+    void parse_11_unicode_escapes();
 private:
     const QString scopeDirPath{"qjson"};
 
@@ -53,6 +110,15 @@ QJsonCompatibility::~QJsonCompatibility()
 
 }
 
+void QJsonCompatibility::cleanupTestCase()
+{
+#ifdef JJSON17_INSTRUMENT
+    std::stringstream ss;
+    instrument::report(ss);
+    qDebug().noquote() << "instrumentation report:\n" << QString::fromStdString(ss.str());
+#endif
+}
+
 #define READ_FILE_BACK() \
     QFile infile(filepath);                     \
     QVERIFY(infile.exists());                   \
@@ -284,7 +350,7 @@ void QJsonCompatibility::test_4_mix_latin_nums()
             Array lst;
             foreach(auto s , t.subordinates)
                 lst.push_back(s.toStdString());
-            r.insert({"subordinates",lst});
+            r.insert({"subordinates",std::move(lst)});
         }
         return r;
     };
@@ -591,6 +657,90 @@ void QJsonCompatibility::test_9_implicit_cast()
 }
 
 
+void QJsonCompatibility::test_10_object_order()
+{
+    using namespace jjson17;
+    using std::string, std::get;
+    //QSKIP("ALREADY COMPLETE");
+
+    //порядок ключей и семантика insert/at/find, которые должна сохранить любая раскладка Object
+    Object obj;
+    std::vector<string> keys = {"delta","alpha","Zulu","echo","bravo","",u8"\u2211","charlie"};
+    int n = 0;
+    for(const auto& k : keys)
+        obj.insert({k,n++});
+    QCOMPARE(obj.size(),keys.size());
+
+    auto inserted = obj.insert({"alpha",100});              //повторный ключ не перезаписывает значение
+    QVERIFY(!inserted.second);
+    QCOMPARE(get<int64_t>(obj.at("alpha")),1);
+
+    std::vector<string> sorted = keys;
+    std::sort(sorted.begin(),sorted.end());
+    std::vector<string> iterated;
+    for(const auto& [k,v] : obj)
+        iterated.push_back(k);
+    QVERIFY(iterated==sorted);
+
+    for(int i = 0; i < int(keys.size()); ++i) {
+        QVERIFY(obj.find(keys[i])!=obj.end());
+        QCOMPARE(get<int64_t>(obj.at(keys[i])),i);
+    }
+    QVERIFY(obj.find("missing")==obj.end());
+    bool goodException{false};
+    try{ obj.at("missing"); } catch(const std::out_of_range& e) {goodException=true;}
+    QVERIFY(goodException);
+
+    std::stringstream ss;
+    ss << obj;
+    auto text = ss.str();
+    size_t pos = 0;
+    for(const auto& k : sorted) {
+        auto next = text.find("\""+k+"\":",pos);
+        QVERIFY2(next!=string::npos, k.data());
+        pos = next+1;
+    }
+}
+
+#ifdef JJSON17_INSTRUMENT
+//subScanFunc-shaped builder over a synthetic tree: `width` entries per level down to `depth`
+static jjson17::Object buildTree(int depth, int width, int level=0)
+{
+    jjson17::Object obj {{"Directory",true},{"Depth",level}};
+    if(level < depth) {
+        jjson17::Object content;
+        for(int i = 0; i < width; ++i)
+            content.insert({"entry_"+std::to_string(i),buildTree(depth,width,level+1)});
+        obj.insert({"content",std::move(content)});
+    }
+    return obj;
+}
+#endif
+
+void QJsonCompatibility::test_11_build_allocations()
+{
+    #ifdef JJSON17_INSTRUMENT
+    //QSKIP("ALREADY COMPLETE");
+
+    //одинаковое число узлов: цепочка глубиной N и один уровень шириной N.
+    //если поддеревья копируются при вставке, цепочка стоит O(N*depth) выделений вместо O(N)
+    const int N = 500;
+    auto countAllocs = [](int depth, int width) {
+        auto before = instrument::threadAllocs;
+        jjson17::Object tree = buildTree(depth,width);
+        auto allocs = instrument::threadAllocs - before;
+        return allocs;
+    };
+    auto flat  = countAllocs(1,N);
+    auto chain = countAllocs(N,1);
+    qDebug() << "allocations, flat :"<<flat<<"chain :"<<chain<<"per node :"<<double(flat)/N<<double(chain)/N;
+    QVERIFY(flat > 0);
+    QVERIFY2(chain <= 2*flat, "deep build copies subtrees on insert");
+    #else
+    QSKIP("allocation counting needs DEFINES += JJSON17_INSTRUMENT");
+    #endif
+}
+
 template <typename PathType>
 static PathType getBigDir() {
 #ifdef Q_OS_WINDOWS
@@ -602,6 +752,107 @@ static PathType getBigDir() {
 #endif
 }
 
+//bytes in use by the malloc heap, -1 if unsupported.
+//Qt containers allocate with malloc directly, so only the heap sees all of a QJson tree
+static long long heapInUseBytes() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    auto info = mallinfo2();
+    return static_cast<long long>(info.uordblks + info.hblkhd);
+#else
+    return -1;
+#endif
+}
+//memory taken by one phase: operator new traffic and the high-water mark of live operator new bytes
+//(JJSON17_INSTRUMENT only, the peak on glibc only, -1 otherwise) and growth of the malloc heap
+struct MemoryProbe {
+    long long heapBefore{heapInUseBytes()};
+#ifdef JJSON17_INSTRUMENT
+    uint64_t  allocBefore{instrument::threadAllocBytes};
+    long long allocated() const { return static_cast<long long>(instrument::threadAllocBytes - allocBefore); }
+#else
+    long long allocated() const { return -1; }
+#endif
+#ifdef JJSON17_LIVE_BYTES
+    int64_t   liveBefore{instrument::liveBytes.load()};
+
+    MemoryProbe() { instrument::resetPeakLiveBytes(); }
+    int64_t   live()      const { return instrument::liveBytes - liveBefore; }
+    int64_t   livePeak()  const { return instrument::peakLiveBytes - liveBefore; }
+#else
+    int64_t   live()      const { return -1; }
+    int64_t   livePeak()  const { return -1; }
+#endif
+    long long heap()      const { return heapBefore < 0 ? -1 : heapInUseBytes() - heapBefore; }
+};
+
+//share of the text that is whitespace outside string literals: indentation and line breaks a compact writer would drop
+static double whitespaceShare(const std::string& text)
+{
+    size_t spaces{0};
+    bool inString{false}, escaped{false};
+    for(char c : text) {
+        if(inString) {
+            if(escaped)         escaped = false;
+            else if(c == '\\')  escaped = true;
+            else if(c == '"')   inString = false;
+        }
+        else if(c == '"') inString = true;
+        else if(c == ' ' || c == '\t' || c == '\n' || c == '\r') spaces++;
+    }
+    return text.empty() ? 0. : double(spaces)/text.size();
+}
+
+//text of a parsed document (an Object or an Array), as operator<< writes it
+static std::string toText(const jjson17::Value& v)
+{
+    std::stringstream ss;
+                      ss.precision(12);
+    if(std::holds_alternative<jjson17::Object>(v))
+         ss << std::get<jjson17::Object>(v);
+    else ss << std::get<jjson17::Array>(v);
+    return ss.str();
+}
+
+//shape of a tree: number of values and how much of the key text is repeated
+struct TreeShape {
+    size_t nodes{0};
+    size_t keyBytes{0};
+    std::set<std::string> distinctKeys;
+};
+static void measureShape(const jjson17::Value& v, TreeShape& shape);
+static void measureShape(const jjson17::Object& obj, TreeShape& shape)
+{
+    for(const auto& [k,v] : obj) {
+        shape.nodes++;
+        shape.keyBytes += k.size();
+        shape.distinctKeys.insert(k);
+        measureShape(v,shape);
+    }
+}
+static void measureShape(const jjson17::Value& v, TreeShape& shape)
+{
+    if(std::holds_alternative<jjson17::Object>(v))
+        measureShape(std::get<jjson17::Object>(v),shape);
+    else if(std::holds_alternative<jjson17::Array>(v))
+        for(const auto& e : std::get<jjson17::Array>(v)) {
+            shape.nodes++;
+            measureShape(e,shape);
+        }
+}
+
+//number of values in a QJson tree, counted like TreeShape::nodes plus the root
+static size_t countNodes(const QJsonValue& v)
+{
+    size_t n = 1;
+    if(v.isObject())
+        for(const auto& e : v.toObject())
+            n += countNodes(e);
+    else if(v.isArray())
+        for(const auto& e : v.toArray())
+            n += countNodes(e);
+    return n;
+}
+
 //recursive dirscan
 static jjson17::Object subScanFunc (std::filesystem::directory_entry entry, int depth, const int MAX_DEPTH=2, const int MAX_ELEMS_AT_LVL=-1)
 {
@@ -626,10 +877,74 @@ static jjson17::Object subScanFunc (std::filesystem::directory_entry entry, int
             content.insert( {d.path().filename().generic_string() , subScanFunc(d,depth,MAX_DEPTH,MAX_ELEMS_AT_LVL)} );//content.insert( {d.path().filename().u8string() , subScanFunc(d,depth)} );
             if(cnt--==0) break;
         }
-        obj.insert({"content",content});
+        obj.insert({"content",std::move(content)});
     }
     return obj;
 }
+//"key":\t prefix of a record, escaped by the library ("key":\tnull without null)
+static std::string recordKey(const std::string& key)
+{
+    auto text = jjson17::to_string(jjson17::Record(key,nullptr));
+    return text.substr(0,text.size()-4);
+}
+//text with `levels` tabs after every line break, as operator<< indents nested objects
+static void writeIndented(std::ostream& os, const std::string& text, int levels)
+{
+    for(char c : text) {
+        os << c;
+        if(c == '\n') os << std::string(levels,'\t');
+    }
+}
+//recursive dirscan, streamed straight to the output without building a tree.
+//the text is byte-identical to operator<< of the subScanFunc tree: keys in Object order,
+//a '\t' per level after every line break, object values as "key":\t\n{
+static void subScanStream (std::ostream& os, std::filesystem::directory_entry entry, int depth, const int MAX_DEPTH=2, const int MAX_ELEMS_AT_LVL=-1, int indent=0)
+{
+    namespace json = jjson17;
+    namespace fs = std::filesystem;
+
+    auto isDir = entry.is_directory();
+    const std::string pad(indent+1,'\t');
+
+    os << "{\n"
+       << pad << json::to_string(json::Record("Depth",depth))                                                 << ",\n"
+       << pad << json::to_string(json::Record("Directory",isDir))                                             << ",\n"
+       << pad << json::to_string(json::Record("Permitions",static_cast<int>(entry.status().permissions())))   << ",\n"
+       << pad << json::to_string(json::Record("Size",isDir?0:entry.file_size()));
+
+    if(isDir && depth < MAX_DEPTH)
+    {
+        depth++;
+        //те же записи, что берёт subScanFunc, но в порядке ключей Object: память O(ширина) на уровень
+        std::vector<fs::directory_entry> entries;
+        int cnt = MAX_ELEMS_AT_LVL;
+        for(const auto& d : fs::directory_iterator(entry,fs::directory_options::skip_permission_denied)) {
+            entries.push_back(d);
+            if(cnt--==0) break;
+        }
+        std::sort(entries.begin(),entries.end(),[](const fs::directory_entry& l, const fs::directory_entry& r) {
+            return l.path().filename().generic_string() < r.path().filename().generic_string();
+        });
+
+        os << ",\n" << pad << recordKey("content") << "\n" << pad;
+        if(entries.empty()) {
+            std::stringstream empty;
+                              empty << json::Object{};
+            writeIndented(os,empty.str(),indent+1);
+        }
+        else {
+            const std::string childPad(indent+2,'\t');
+            os << "{\n";
+            for(size_t i = 0; i < entries.size(); ++i) {
+                if(i) os << ",\n";
+                os << childPad << recordKey(entries[i].path().filename().generic_string()) << "\n" << childPad;
+                subScanStream(os,entries[i],depth,MAX_DEPTH,MAX_ELEMS_AT_LVL,indent+2);
+            }
+            os << "\n" << pad << "}";
+        }
+    }
+    os << "\n" << std::string(indent,'\t') << "}";
+}
 //recursive dirscan
 static QJsonObject subScanFunc (const QFileInfo& entry, int depth, const int MAX_DEPTH=2, const int MAX_ELEMS_AT_LVL=-1)
 {
@@ -655,6 +970,83 @@ static QJsonObject subScanFunc (const QFileInfo& entry, int depth, const int MAX
     return obj;
 }
 
+//thread counts to try: powers of two below maxThreads and maxThreads itself (6 or 12 cores are not a power of two)
+static std::vector<unsigned> threadCounts(unsigned maxThreads)
+{
+    std::vector<unsigned> counts;
+    for(unsigned threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+//parallel rendering: subtrees below LEVELS are rendered on worker threads, the rest is stitched
+//so that the text is byte-identical to operator<< (nested levels differ only by a leading '\t')
+namespace parallel_write {
+static void plan(const jjson17::Object& obj, int levels, std::vector<const jjson17::Object*>& tasks)
+{
+    if(levels == 0 || obj.empty()) { tasks.push_back(&obj); return; }
+    for(const auto& [k,v] : obj)
+        if(std::holds_alternative<jjson17::Object>(v))
+            plan(std::get<jjson17::Object>(v),levels-1,tasks);
+}
+static void run(const std::vector<const jjson17::Object*>& tasks, std::vector<std::string>& results, unsigned threads)
+{
+    results.assign(tasks.size(),{});
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for(size_t i = next++; i < tasks.size(); i = next++) {
+            JJSON17_SCOPE("parallel_write.task");
+            std::stringstream ss;
+                              ss.precision(12);
+                              ss << *tasks[i];
+            results[i] = ss.str();
+        }
+    };
+    std::vector<std::thread> pool;
+    for(unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for(auto& t : pool)
+        t.join();
+}
+static void indent(const std::string& text, std::string& out)
+{
+    out += '\t';
+    for(char c : text) {
+        out += c;
+        if(c == '\n') out += '\t';
+    }
+}
+static std::string assemble(const jjson17::Object& obj, int levels, const std::vector<std::string>& results, size_t& idx)
+{
+    namespace json = jjson17;
+    if(levels == 0 || obj.empty()) return results[idx++];
+    std::string out = "{\n";
+    bool first{true};
+    for(const auto& [k,v] : obj) {
+        if(!first) out += ",\n";
+        first = false;
+        if(std::holds_alternative<json::Object>(v)) {
+            auto key = json::to_string(json::Record(k,nullptr));             //"key":\tnull без null
+            indent(key.substr(0,key.size()-4)+"\n"+assemble(std::get<json::Object>(v),levels-1,results,idx),out);
+        }
+        else indent(json::to_string(json::Record(k,v)),out);
+    }
+    out += "\n}";
+    return out;
+}
+static std::string render(const jjson17::Object& obj, int levels, unsigned threads)
+{
+    std::vector<const jjson17::Object*> tasks;
+    std::vector<std::string> results;
+    plan(obj,levels,tasks);
+    run(tasks,results,threads);
+    size_t idx{0};
+    return assemble(obj,levels,results,idx);
+}
+}
+
 #define RAW_OFSTREAM    // служит для изменения способа записи напрямую через ofstream или через sstream
 void QJsonCompatibility::perf_1_dirscan()
 {
@@ -675,14 +1067,31 @@ void QJsonCompatibility::perf_1_dirscan()
     {
         fs::directory_entry stdDir(getBigDir<std::string>());
         QVERIFY(stdDir.exists());
+        MemoryProbe mem;
         auto before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(buildScope,"jjson17.build");
         json::Object jsonDirRoot = subScanFunc(stdDir,0);
+        JJSON17_SCOPE_END(buildScope);
         auto after = steady_clock::now();
         auto ms = duration_cast<std::chrono::milliseconds>(after - before);
         qDebug() << "JJSON17. time to build :"<<ms.count()<<"ms";
+        qDebug() << "JJSON17. allocated :"<<mem.allocated()<<"bytes, live :"<<mem.live()<<"live peak :"<<mem.livePeak()<<"heap :"<<mem.heap()<<"bytes";
         jjTotal+=ms.count();
         QString filepath = dirpath+"/test_jj17.json";
+        qint64 serializeMs{0};
+      #ifdef RAW_OFSTREAM
+        {
+            //отдельный проход в память: время сериализации без файлового ввода-вывода
+            before = steady_clock::now();
+            std::stringstream ss;
+                              ss.precision(12);
+                              ss << jsonDirRoot;
+            serializeMs = duration_cast<std::chrono::milliseconds>(steady_clock::now() - before).count();
+            qDebug() << "JJSON17. time to serialize :"<<serializeMs<<"ms";
+        }
+      #endif
         before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(writeScope,"jjson17.write");
       #ifdef RAW_OFSTREAM
             std::ofstream ofs;
                           ofs.precision(12);
@@ -694,15 +1103,35 @@ void QJsonCompatibility::perf_1_dirscan()
             std::stringstream ss;
                               ss.precision(12);
                               ss << jsonDirRoot;
+            auto serialized = steady_clock::now();
+            serializeMs = duration_cast<std::chrono::milliseconds>(serialized - before).count();
+            qDebug() << "JJSON17. time to serialize :"<<serializeMs<<"ms";
             std::ofstream ofs;
                           ofs.open(filepath.toStdString());
-                          ofs << ss.str();
+                          ofs << ss.rdbuf();
                           ofs.close();
       #endif
+        JJSON17_SCOPE_END(writeScope);
         after = steady_clock::now();
         ms = duration_cast<std::chrono::milliseconds>(after - before);
         jjTotal+=ms.count();
         qDebug() << "JJSON17. time to write :"<<ms.count()<<"ms";
+        auto bytes = QFileInfo(filepath).size();
+        qDebug() << "JJSON17. written :"<<bytes<<"bytes"<<bytes/1048576./std::max<qint64>(ms.count(),1)*1000<<"MB/s";
+        qDebug() << "JJSON17. serialize :"<<bytes/1048576./std::max<qint64>(serializeMs,1)*1000<<"MB/s, share of write time"<<double(serializeMs)/std::max<qint64>(ms.count(),1);
+        {
+            std::ifstream written(filepath.toStdString(), std::ios::binary);
+            std::string text((std::istreambuf_iterator<char>(written)), std::istreambuf_iterator<char>());
+            qDebug() << "JJSON17. whitespace share :"<<whitespaceShare(text);
+        }
+        before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(destroyScope,"jjson17.destroy");
+        jsonDirRoot.clear();
+        JJSON17_SCOPE_END(destroyScope);
+        after = steady_clock::now();
+        ms = duration_cast<std::chrono::milliseconds>(after - before);
+        jjTotal+=ms.count();
+        qDebug() << "JJSON17. time to destroy :"<<ms.count()<<"ms";
         qDebug() << "JJSON17. total :"<<jjTotal<<"ms";
     }
     //........................
@@ -712,24 +1141,55 @@ void QJsonCompatibility::perf_1_dirscan()
     {
         QFileInfo qDir(getBigDir<QString>());
         QVERIFY(qDir.exists());
+        MemoryProbe mem;
         auto before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(buildScope,"qjson.build");
         auto jsonDirRoot = subScanFunc(qDir,0);
+        JJSON17_SCOPE_END(buildScope);
         auto after = steady_clock::now();
         auto ms = duration_cast<std::chrono::milliseconds>(after - before);
         qDebug() << "QJSON. time to build :"<<ms.count()<<"ms";
+        qDebug() << "QJSON. allocated :"<<mem.allocated()<<"bytes, live :"<<mem.live()<<"live peak :"<<mem.livePeak()<<"heap :"<<mem.heap()<<"bytes";
         qTotal+=ms.count();
 
         QString filepath = dirpath+"/test_q.json";
         before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(writeScope,"qjson.write");
             QJsonDocument qjsdoc(jsonDirRoot);
             QFile   f(filepath);
                     f.open(QIODevice::WriteOnly);
                     f.write(qjsdoc.toJson());
                     f.close();
+        JJSON17_SCOPE_END(writeScope);
         after = steady_clock::now();
         ms = duration_cast<std::chrono::milliseconds>(after - before);
         qTotal+=ms.count();
         qDebug() << "QJSON. time to write :"<<ms.count()<<"ms";
+        auto bytes = QFileInfo(filepath).size();
+        qDebug() << "QJSON. written :"<<bytes<<"bytes"<<bytes/1048576./std::max<qint64>(ms.count(),1)*1000<<"MB/s";
+
+        filepath = dirpath+"/test_q_compact.json";
+        before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(compactScope,"qjson.write_compact");
+                    f.setFileName(filepath);
+                    f.open(QIODevice::WriteOnly);
+                    f.write(qjsdoc.toJson(QJsonDocument::Compact));
+                    f.close();
+        JJSON17_SCOPE_END(compactScope);
+        after = steady_clock::now();
+        ms = duration_cast<std::chrono::milliseconds>(after - before);
+        auto compactBytes = QFileInfo(filepath).size();
+        qDebug() << "QJSON. time to write (compact) :"<<ms.count()<<"ms";
+        qDebug() << "QJSON. written (compact) :"<<compactBytes<<"bytes, whitespace share"<<1.-double(compactBytes)/bytes;
+        before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(destroyScope,"qjson.destroy");
+        qjsdoc = QJsonDocument();
+        jsonDirRoot = QJsonObject();
+        JJSON17_SCOPE_END(destroyScope);
+        after = steady_clock::now();
+        ms = duration_cast<std::chrono::milliseconds>(after - before);
+        qTotal+=ms.count();
+        qDebug() << "QJSON. time to destroy :"<<ms.count()<<"ms";
         qDebug() << "QJSON. total :"<<qTotal<<"ms";
     }
 
@@ -765,14 +1225,40 @@ void QJsonCompatibility::perf_2_dirscan()
     {
         fs::directory_entry stdDir(getBigDir<std::string>()+"/..");
         QVERIFY(stdDir.exists());
+        MemoryProbe mem;
         auto before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(buildScope,"jjson17.build");
         json::Object jsonDirRoot = subScanFunc(stdDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+        JJSON17_SCOPE_END(buildScope);
         auto after = steady_clock::now();
         auto ms = duration_cast<std::chrono::milliseconds>(after - before);
         qDebug() << "JJSON17. time to build :"<<ms.count()<<"ms";
+        auto treeBytes = mem.heap();        //одна мера для обоих деревьев: operator new не добавляет к блокам заголовок
+        qDebug() << "JJSON17. allocated :"<<mem.allocated()<<"bytes, live :"<<mem.live()<<"live peak :"<<mem.livePeak()<<"heap :"<<mem.heap()<<"bytes";
+        TreeShape shape;
+        measureShape(jsonDirRoot,shape);
+        size_t treeNodes = shape.nodes+1;
+        size_t distinctKeyBytes{0};
+        for(const auto& k : shape.distinctKeys)
+            distinctKeyBytes += k.size();
+        qDebug() << "JJSON17. nodes :"<<treeNodes<<"bytes per node :"<<(treeBytes < 0 ? -1. : double(treeBytes)/treeNodes);
+        qDebug() << "JJSON17. key bytes :"<<shape.keyBytes<<"distinct :"<<distinctKeyBytes<<"in"<<shape.distinctKeys.size()<<"keys";
         jjTotal+=ms.count();
         QString filepath = dirpath+"/test_jj17.json";
+        qint64 serializeMs{0};
+      #ifdef RAW_OFSTREAM
+        {
+            //отдельный проход в память: время сериализации без файлового ввода-вывода
+            before = steady_clock::now();
+            std::stringstream ss;
+                              ss.precision(12);
+                              ss << jsonDirRoot;
+            serializeMs = duration_cast<std::chrono::milliseconds>(steady_clock::now() - before).count();
+            qDebug() << "JJSON17. time to serialize :"<<serializeMs<<"ms";
+        }
+      #endif
         before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(writeScope,"jjson17.write");
       #ifdef RAW_OFSTREAM
             std::ofstream ofs;
                           ofs.precision(12);
@@ -784,15 +1270,35 @@ void QJsonCompatibility::perf_2_dirscan()
             std::stringstream ss;
                               ss.precision(12);
                               ss << jsonDirRoot;
+            auto serialized = steady_clock::now();
+            serializeMs = duration_cast<std::chrono::milliseconds>(serialized - before).count();
+            qDebug() << "JJSON17. time to serialize :"<<serializeMs<<"ms";
             std::ofstream ofs;
                           ofs.open(filepath.toStdString());
-                          ofs << ss.str();
+                          ofs << ss.rdbuf();
                           ofs.close();
       #endif
+        JJSON17_SCOPE_END(writeScope);
         after = steady_clock::now();
         ms = duration_cast<std::chrono::milliseconds>(after - before);
         jjTotal+=ms.count();
         qDebug() << "JJSON17. time to write :"<<ms.count()<<"ms";
+        auto bytes = QFileInfo(filepath).size();
+        qDebug() << "JJSON17. written :"<<bytes<<"bytes"<<bytes/1048576./std::max<qint64>(ms.count(),1)*1000<<"MB/s";
+        qDebug() << "JJSON17. serialize :"<<bytes/1048576./std::max<qint64>(serializeMs,1)*1000<<"MB/s, share of write time"<<double(serializeMs)/std::max<qint64>(ms.count(),1);
+        {
+            std::ifstream written(filepath.toStdString(), std::ios::binary);
+            std::string text((std::istreambuf_iterator<char>(written)), std::istreambuf_iterator<char>());
+            qDebug() << "JJSON17. whitespace share :"<<whitespaceShare(text);
+        }
+        before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(destroyScope,"jjson17.destroy");
+        jsonDirRoot.clear();
+        JJSON17_SCOPE_END(destroyScope);
+        after = steady_clock::now();
+        ms = duration_cast<std::chrono::milliseconds>(after - before);
+        jjTotal+=ms.count();
+        qDebug() << "JJSON17. time to destroy :"<<ms.count()<<"ms";
         qDebug() << "JJSON17. total :"<<jjTotal<<"ms";
     }
     //........................
@@ -802,24 +1308,58 @@ void QJsonCompatibility::perf_2_dirscan()
     {
         QFileInfo qDir(getBigDir<QString>()+"/..");
         QVERIFY(qDir.exists());
+        MemoryProbe mem;
         auto before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(buildScope,"qjson.build");
         auto jsonDirRoot = subScanFunc(qDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+        JJSON17_SCOPE_END(buildScope);
         auto after = steady_clock::now();
         auto ms = duration_cast<std::chrono::milliseconds>(after - before);
         qDebug() << "QJSON. time to build :"<<ms.count()<<"ms";
+        auto treeBytes = mem.heap();
+        qDebug() << "QJSON. allocated :"<<mem.allocated()<<"bytes, live :"<<mem.live()<<"live peak :"<<mem.livePeak()<<"heap :"<<mem.heap()<<"bytes";
+        auto treeNodes = countNodes(jsonDirRoot);   //QDir и directory_iterator оставляют разные записи при MAX_ELEMS_AT_LVL
+        qDebug() << "QJSON. nodes :"<<treeNodes<<"bytes per node :"<<(treeBytes < 0 ? -1. : double(treeBytes)/treeNodes);
         qTotal+=ms.count();
 
         QString filepath = dirpath+"/test_q.json";
         before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(writeScope,"qjson.write");
             QJsonDocument qjsdoc(jsonDirRoot);
             QFile   f(filepath);
                     f.open(QIODevice::WriteOnly);
                     f.write(qjsdoc.toJson());
                     f.close();
+        JJSON17_SCOPE_END(writeScope);
         after = steady_clock::now();
         ms = duration_cast<std::chrono::milliseconds>(after - before);
         qTotal+=ms.count();
         qDebug() << "QJSON. time to write :"<<ms.count()<<"ms";
+        auto bytes = QFileInfo(filepath).size();
+        qDebug() << "QJSON. written :"<<bytes<<"bytes"<<bytes/1048576./std::max<qint64>(ms.count(),1)*1000<<"MB/s";
+
+        filepath = dirpath+"/test_q_compact.json";
+        before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(compactScope,"qjson.write_compact");
+                    f.setFileName(filepath);
+                    f.open(QIODevice::WriteOnly);
+                    f.write(qjsdoc.toJson(QJsonDocument::Compact));
+                    f.close();
+        JJSON17_SCOPE_END(compactScope);
+        after = steady_clock::now();
+        ms = duration_cast<std::chrono::milliseconds>(after - before);
+        auto compactBytes = QFileInfo(filepath).size();
+        qDebug() << "QJSON. time to write (compact) :"<<ms.count()<<"ms";
+        qDebug() << "QJSON. written (compact) :"<<compactBytes<<"bytes, whitespace share"<<1.-double(compactBytes)/bytes;
+        before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(destroyScope,"qjson.destroy");
+        qjsdoc = QJsonDocument();
+        jsonDirRoot = QJsonObject();
+        JJSON17_SCOPE_END(destroyScope);
+        after = steady_clock::now();
+        ms = duration_cast<std::chrono::milliseconds>(after - before);
+        qTotal+=ms.count();
+        qDebug() << "QJSON. time to destroy :"<<ms.count()<<"ms";
         qDebug() << "QJSON. total :"<<qTotal<<"ms";
     }
 
@@ -832,90 +1372,588 @@ void QJsonCompatibility::perf_2_dirscan()
     #endif
 }
 
-void QJsonCompatibility::parse_1_numbers()
+void QJsonCompatibility::perf_3_parse_dirscan()
 {
-    using namespace std;
-    using namespace jjson17;
+    #ifdef PERFOMANCE_TEST
+    namespace json = jjson17;
+    namespace fs = std::filesystem;
+    using namespace std::chrono;
 
     //QSKIP("ALREADY COMPLETE");
 
-    QString dirpath  = scopeDirPath+"/parse_1_numbers";
-    QString filepath = dirpath+"/test_q.json";
+    const int MAX_DEPTH = 20;
+    const int MAX_ELEMS_AT_LVL = 20;
+
+    QString dirpath = scopeDirPath+"/perf_3_parse_dirscan";
     QDir dir("./");
          dir.mkpath(dirpath);
          dir.cd(dirpath);
-    QJsonObject qjsobj;
-                qjsobj.insert("First"  ,1);
-                qjsobj.insert("Second" ,2);
-                qjsobj.insert("Third"  ,1.11);
-                qjsobj.insert("Forth"  ,-9);
-                qjsobj.insert("Fifth"  ,-0.625);
-                qjsobj.insert("Sixth"  ,0);
-                qjsobj.insert("Seventh",-2.125);
-    QJsonDocument qjsdoc(qjsobj);
-    QFile   f(filepath);
-            f.open(QIODevice::WriteOnly);
-            f.write(qjsdoc.toJson());
-            f.close();
-    ifstream infile;
-             infile.open(filepath.toStdString());
-    auto jj17doc = parse(infile);
-             infile.close();
-    QVERIFY(holds_alternative<Object>(jj17doc));
-    Object& jj17obj = get<Object>(jj17doc);
-    QCOMPARE(jj17obj.size(),7);
-    for(const auto& v : jj17obj)
-        qDebug() << QString::fromStdString(v.first) << v.second.index();
-    QVERIFY(holds_alternative<int64_t>(jj17obj["First"  ]));
-    QVERIFY(holds_alternative<int64_t>(jj17obj["Second" ]));
-    QVERIFY(holds_alternative<double >(jj17obj["Third"  ]));
-    QVERIFY(holds_alternative<int64_t>(jj17obj["Forth"  ]));
-    QVERIFY(holds_alternative<double >(jj17obj["Fifth"  ]));
-    QVERIFY(holds_alternative<int64_t>(jj17obj["Sixth"  ]));
-    QVERIFY(holds_alternative<double >(jj17obj["Seventh"]));
-    QCOMPARE(get<int64_t>(jj17obj["First"  ]),1);
-    QCOMPARE(get<int64_t>(jj17obj["Second" ]),2);
-    QCOMPARE(get<double >(jj17obj["Third"  ]),1.11);
-    QCOMPARE(get<int64_t>(jj17obj["Forth"  ]),-9);
-    QCOMPARE(get<double >(jj17obj["Fifth"  ]),-0.625);
-    QCOMPARE(get<int64_t>(jj17obj["Sixth"  ]),0);
-    QCOMPARE(get<double >(jj17obj["Seventh"]),-2.125);
-
-    QJsonArray qjsarr = { 3,4,2.55,-390,-0.078,0,-10.001 };
-    qjsdoc.setArray(qjsarr);
-    filepath = dirpath+"/test_q2.json";
-        f.setFileName(filepath);
-        f.open(QIODevice::WriteOnly);
-        f.write(qjsdoc.toJson());
-        f.close();
-    infile.open(filepath.toStdString());
-    jj17doc = parse(infile);
-    infile.close();
-    QVERIFY(holds_alternative<Array>(jj17doc));
-    Array& jj17arr = get<Array>(jj17doc);
-    QCOMPARE(jj17arr.size(),7);
-    QVERIFY(holds_alternative<int64_t>(jj17arr[0]));
-    QVERIFY(holds_alternative<int64_t>(jj17arr[1]));
-    QVERIFY(holds_alternative<double >(jj17arr[2]));
-    QVERIFY(holds_alternative<int64_t>(jj17arr[3]));
-    QVERIFY(holds_alternative<double >(jj17arr[4]));
-    QVERIFY(holds_alternative<int64_t>(jj17arr[5]));
-    QVERIFY(holds_alternative<double >(jj17arr[6]));
-    QCOMPARE(get<int64_t>(jj17arr[0]),3);
-    QCOMPARE(get<int64_t>(jj17arr[1]),4);
-    QCOMPARE(get<double >(jj17arr[2]),2.55);
-    QCOMPARE(get<int64_t>(jj17arr[3]),-390);
-    QCOMPARE(get<double >(jj17arr[4]),-0.078);
-    QCOMPARE(get<int64_t>(jj17arr[5]),0);
-    QCOMPARE(get<double >(jj17arr[6]),-10.001);
+    QString filepath = dirpath+"/test_jj17.json";
 
+    //....... подготовка документа .......
+    {
+        fs::directory_entry stdDir(getBigDir<std::string>()+"/..");
+        QVERIFY(stdDir.exists());
+        json::Object jsonDirRoot = subScanFunc(stdDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+        std::ofstream ofs;
+                      ofs.precision(12);
+                      ofs.open(filepath.toStdString());
+                      ofs << jsonDirRoot;
+                      ofs.close();
+    }
+    qDebug() << "document size :"<<QFileInfo(filepath).size()<<"bytes";
 
-    dir.removeRecursively();
-}
+    //....... std-way: istream  .......
+    uint32_t    jjStreamTotal{0};
+    std::string jjStreamText;                       //разбор перезаписывается в текст, чтобы сравнивать деревья целиком
+    {
+        auto before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(parseScope,"jjson17.parse_ifstream");
+        std::ifstream infile;
+                      infile.open(filepath.toStdString());
+        auto jj17doc = json::parse(infile);
+                      infile.close();
+        JJSON17_SCOPE_END(parseScope);
+        auto after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before);
+        QVERIFY(std::holds_alternative<json::Object>(jj17doc));
+        jjStreamText = toText(jj17doc);
+        jjStreamTotal = ms.count();
+        qDebug() << "JJSON17. time to parse (ifstream) :"<<ms.count()<<"ms";
+    }
+    //....... std-way: contiguous buffer  .......
+    //отдельного разбора из буфера у библиотеки нет: буфер снова копируется в istringstream,
+    //так что это тот же istream-разбор плюс чтение файла одним куском
+    uint32_t jjBufferTotal{0};
+    {
+        auto before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(parseScope,"jjson17.parse_buffer");
+        std::ifstream infile(filepath.toStdString(), std::ios::binary);
+        std::string buffer((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+                      infile.close();
+        auto afterRead = steady_clock::now();
+        std::istringstream iss(buffer);
+        auto jj17doc = json::parse(iss);
+        JJSON17_SCOPE_END(parseScope);
+        auto after = steady_clock::now();
+        auto msRead = duration_cast<std::chrono::milliseconds>(afterRead - before);
+        auto ms     = duration_cast<std::chrono::milliseconds>(after - before);
+        QVERIFY(std::holds_alternative<json::Object>(jj17doc));
+        QVERIFY(toText(jj17doc)==jjStreamText);
+        jjBufferTotal = ms.count();
+        qDebug() << "JJSON17. time to read buffer :"<<msRead.count()<<"ms";
+        qDebug() << "JJSON17. time to parse (buffer copied into istringstream) :"<<ms.count()<<"ms";
+    }
+    //........................
+    //....... QT-way  ........
 
-void QJsonCompatibility::parse_2_numbers_self()
-{
-    using namespace std;
+    uint32_t qTotal{0};
+    {
+        auto before = steady_clock::now();
+        JJSON17_SCOPE_BEGIN(parseScope,"qjson.parse");
+        QFile infile(filepath);
+        QVERIFY(infile.open(QIODevice::ReadOnly));
+        QByteArray allData = infile.readAll();
+        infile.close();
+        auto doc = QJsonDocument::fromJson(allData);
+        JJSON17_SCOPE_END(parseScope);
+        auto after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before);
+        QVERIFY(doc.isObject());
+        QVERIFY(doc==QJsonDocument::fromJson(QByteArray::fromStdString(jjStreamText)));
+        qTotal = ms.count();
+        qDebug() << "QJSON. time to parse :"<<ms.count()<<"ms";
+    }
+
+    //........................
+    qDebug()  << "JJSON(ifstream) vs QJSON"<< double(jjStreamTotal)/qTotal<<"the less the best";
+    qDebug()  << "JJSON(buffer copied into istringstream) vs QJSON"<< double(jjBufferTotal)/qTotal<<"the less the best";
+
+    dir.removeRecursively();
+    #else
+    QSKIP("skip perfomance test");
+    #endif
+}
+
+void QJsonCompatibility::perf_4_parse_large()
+{
+    #ifdef PERFOMANCE_TEST
+    namespace json = jjson17;
+    using namespace std::chrono;
+
+    //QSKIP("ALREADY COMPLETE");
+
+    //размер документа задаётся переменной окружения (по умолчанию 128 МБ, для 1 ГБ: JJSON17_PERF_LARGE_MB=1024)
+    const qint64 MEGABYTES = qEnvironmentVariableIsSet("JJSON17_PERF_LARGE_MB")
+                           ? qEnvironmentVariableIntValue("JJSON17_PERF_LARGE_MB") : 128;
+
+    QString dirpath = scopeDirPath+"/perf_4_parse_large";
+    QDir dir("./");
+         dir.mkpath(dirpath);
+         dir.cd(dirpath);
+    QString filepath = dirpath+"/test_jj17.json";
+
+    //....... генерация: записи лога пишутся по одной, память не растёт .......
+    size_t records{0};
+    {
+        auto before = steady_clock::now();
+        std::ofstream ofs;
+                      ofs.precision(12);
+                      ofs.open(filepath.toStdString());
+                      ofs << "[\n";
+        for(; ofs.tellp() < MEGABYTES*1048576; ++records) {
+            json::Object rec {
+                {"id"     ,int64_t(records)},
+                {"level"  ,records%7 ? "info" : "warning"},
+                {"message","request \"GET /api/v1/items\" handled"},
+                {"latency",records*0.001+0.5},
+                {"ok"     ,records%13 != 0},
+                {"tags"   ,json::Array{"net","http",int64_t(records%100)}}
+            };
+            if(records) ofs << ",\n";
+            ofs << rec;
+        }
+                      ofs << "\n]";
+                      ofs.close();
+        auto after = steady_clock::now();
+        qDebug() << "generated :"<<records<<"records"<<QFileInfo(filepath).size()<<"bytes in"
+                 << duration_cast<std::chrono::milliseconds>(after - before).count()<<"ms";
+    }
+
+    //....... DOM parse  .......
+    {
+        MemoryProbe mem;
+        auto before = steady_clock::now();
+        std::ifstream infile;
+                      infile.open(filepath.toStdString());
+        auto jj17doc = json::parse(infile);
+                      infile.close();
+        auto after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before);
+        QVERIFY(std::holds_alternative<json::Array>(jj17doc));
+        QCOMPARE(std::get<json::Array>(jj17doc).size(),records);
+        qDebug() << "JJSON17. time to parse :"<<ms.count()<<"ms"
+                 << QFileInfo(filepath).size()/1048576./std::max<qint64>(ms.count(),1)*1000<<"MB/s";
+        qDebug() << "JJSON17. document heap :"<<mem.heap()<<"bytes, live peak :"<<mem.livePeak()<<"bytes";
+    }
+
+    dir.removeRecursively();
+    #else
+    QSKIP("skip perfomance test");
+    #endif
+}
+
+void QJsonCompatibility::perf_5_dirscan_streaming()
+{
+    #ifdef PERFOMANCE_TEST
+    namespace json = jjson17;
+    namespace fs = std::filesystem;
+    using namespace std::chrono;
+
+    //QSKIP("ALREADY COMPLETE");
+
+    const int MAX_DEPTH = 20;
+    const int MAX_ELEMS_AT_LVL = 20;
+
+    QString dirpath = scopeDirPath+"/perf_5_dirscan_streaming";
+    QDir dir("./");
+         dir.mkpath(dirpath);
+         dir.cd(dirpath);
+    QString streamedpath = dirpath+"/test_jj17_stream.json";
+    QString builtpath    = dirpath+"/test_jj17.json";
+
+    //....... streaming: O(depth) памяти  .......
+    uint32_t streamTotal{0};
+    {
+        fs::directory_entry stdDir(getBigDir<std::string>()+"/..");
+        QVERIFY(stdDir.exists());
+        MemoryProbe mem;
+        auto before = steady_clock::now();
+        std::ofstream ofs;
+                      ofs.precision(12);
+                      ofs.open(streamedpath.toStdString());
+                      subScanStream(ofs,stdDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+                      ofs.close();
+        auto after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before);
+        streamTotal = ms.count();
+        qDebug() << "JJSON17. streaming scan+write :"<<ms.count()<<"ms";
+        qDebug() << "JJSON17. streaming live peak :"<<mem.livePeak()<<"bytes";
+    }
+    //....... build-then-write  .......
+    uint32_t buildTotal{0};
+    {
+        fs::directory_entry stdDir(getBigDir<std::string>()+"/..");
+        QVERIFY(stdDir.exists());
+        MemoryProbe mem;
+        auto before = steady_clock::now();
+        json::Object jsonDirRoot = subScanFunc(stdDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+        std::ofstream ofs;
+                      ofs.precision(12);
+                      ofs.open(builtpath.toStdString());
+                      ofs << jsonDirRoot;
+                      ofs.close();
+        auto after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before);
+        buildTotal = ms.count();
+        qDebug() << "JJSON17. build+write :"<<ms.count()<<"ms";
+        qDebug() << "JJSON17. build+write live peak :"<<mem.livePeak()<<"bytes";
+    }
+
+    //....... потоковая запись должна совпадать с operator<< побайтово  .......
+    {
+        QFile streamed(streamedpath);
+        QFile built(builtpath);
+        QVERIFY(streamed.open(QIODevice::ReadOnly));
+        QVERIFY(built.open(QIODevice::ReadOnly));
+        auto streamedText = streamed.readAll();
+        auto builtText    = built.readAll();
+        QVERIFY(!builtText.isEmpty());
+        QVERIFY(streamedText==builtText);
+    }
+
+    qDebug()  << "streaming vs build-then-write"<< double(streamTotal)/buildTotal<<"the less the best";
+
+    dir.removeRecursively();
+    #else
+    QSKIP("skip perfomance test");
+    #endif
+}
+
+void QJsonCompatibility::perf_6_dirscan_parallel_write()
+{
+    #ifdef PERFOMANCE_TEST
+    namespace json = jjson17;
+    namespace fs = std::filesystem;
+    using namespace std::chrono;
+
+    //QSKIP("ALREADY COMPLETE");
+
+    const int MAX_DEPTH = 20;
+    const int MAX_ELEMS_AT_LVL = 20;
+    const int SPLIT_LEVELS = 3;
+
+    fs::directory_entry stdDir(getBigDir<std::string>()+"/..");
+    QVERIFY(stdDir.exists());
+    json::Object jsonDirRoot = subScanFunc(stdDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+
+    //....... последовательная запись  .......
+    auto before = steady_clock::now();
+    std::stringstream ss;
+                      ss.precision(12);
+                      ss << jsonDirRoot;
+    std::string sequential = ss.str();
+    auto after = steady_clock::now();
+    auto seqMs = duration_cast<std::chrono::milliseconds>(after - before).count();
+    qDebug() << "JJSON17. sequential serialize :"<<seqMs<<"ms"<<sequential.size()<<"bytes";
+
+    //....... параллельная запись по числу потоков  .......
+    const unsigned maxThreads = std::max(1u,std::thread::hardware_concurrency());
+    for(unsigned threads : threadCounts(maxThreads))
+    {
+        before = steady_clock::now();
+        std::string parallel = parallel_write::render(jsonDirRoot,SPLIT_LEVELS,threads);
+        after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before).count();
+        QVERIFY2(parallel==sequential, QString("threads %1").arg(threads).toLatin1());
+        qDebug() << "JJSON17. parallel serialize, threads"<<threads<<":"<<ms<<"ms, speedup"<<double(seqMs)/std::max<qint64>(ms,1);
+    }
+    #else
+    QSKIP("skip perfomance test");
+    #endif
+}
+
+void QJsonCompatibility::perf_7_parse_read_fields()
+{
+    #ifdef PERFOMANCE_TEST
+    namespace json = jjson17;
+    using namespace std::chrono;
+
+    //QSKIP("ALREADY COMPLETE");
+
+    const int RECORDS = 200000;
+
+    QString dirpath = scopeDirPath+"/perf_7_parse_read_fields";
+    QDir dir("./");
+         dir.mkpath(dirpath);
+         dir.cd(dirpath);
+    QString filepath = dirpath+"/test_jj17.json";
+
+    //....... большой документ, из которого нужны только три поля .......
+    {
+        json::Array payload;
+        payload.reserve(RECORDS);
+        for(int i = 0; i < RECORDS; ++i)
+            payload.push_back(json::Object{{"id",i},{"name","item "+std::to_string(i)},{"price",i*0.01},{"tags",json::Array{"a","b"}}});
+        json::Object doc {
+            {"name"   ,"config"},
+            {"version",42},
+            {"owner"  ,json::Object{{"id",7},{"login","root"}}}
+        };
+        doc.insert({"payload",std::move(payload)});     //элементы initializer_list копируются, поэтому payload вставляется отдельно
+        std::ofstream ofs;
+                      ofs.precision(12);
+                      ofs.open(filepath.toStdString());
+                      ofs << doc;
+                      ofs.close();
+    }
+    qDebug() << "document size :"<<QFileInfo(filepath).size()<<"bytes";
+
+    //....... std-way: полный разбор, затем три поля  .......
+    uint32_t jjTotal{0};
+    {
+        auto before = steady_clock::now();
+        std::ifstream infile;
+                      infile.open(filepath.toStdString());
+        auto jj17doc = json::parse(infile);
+                      infile.close();
+        const auto& obj = std::get<json::Object>(jj17doc);
+        std::string name    = obj.at("name");
+        int         version = obj.at("version");
+        int         ownerId = std::get<json::Object>(obj.at("owner")).at("id");
+        auto after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before);
+        jjTotal = ms.count();
+        QCOMPARE(name,std::string("config"));
+        QCOMPARE(version,42);
+        QCOMPARE(ownerId,7);
+        qDebug() << "JJSON17. parse + 3 fields :"<<ms.count()<<"ms";
+    }
+    //........................
+    //....... QT-way  ........
+
+    uint32_t qTotal{0};
+    {
+        auto before = steady_clock::now();
+        QFile infile(filepath);
+        QVERIFY(infile.open(QIODevice::ReadOnly));
+        auto doc = QJsonDocument::fromJson(infile.readAll());
+        infile.close();
+        auto obj = doc.object();
+        QString name    = obj["name"].toString();
+        int     version = obj["version"].toInt();
+        int     ownerId = obj["owner"].toObject()["id"].toInt();
+        auto after = steady_clock::now();
+        auto ms = duration_cast<std::chrono::milliseconds>(after - before);
+        qTotal = ms.count();
+        QCOMPARE(name,QString("config"));
+        QCOMPARE(version,42);
+        QCOMPARE(ownerId,7);
+        qDebug() << "QJSON. parse + 3 fields :"<<ms.count()<<"ms";
+    }
+
+    //........................
+    qDebug()  << "JJSON vs QJSON"<< double(jjTotal)/qTotal<<"the less the best";
+
+    dir.removeRecursively();
+    #else
+    QSKIP("skip perfomance test");
+    #endif
+}
+
+void QJsonCompatibility::perf_8_dirscan_binary()
+{
+    #ifdef PERFOMANCE_TEST
+    namespace json = jjson17;
+    namespace fs = std::filesystem;
+    using namespace std::chrono;
+
+    //QSKIP("ALREADY COMPLETE");
+
+    const int MAX_DEPTH = 20;
+    const int MAX_ELEMS_AT_LVL = 20;
+
+    //....... std-way: текст jjson17  .......
+    std::string jjText;
+    {
+        fs::directory_entry stdDir(getBigDir<std::string>()+"/..");
+        QVERIFY(stdDir.exists());
+        json::Object jsonDirRoot = subScanFunc(stdDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+        auto before = steady_clock::now();
+        std::stringstream ss;
+                          ss.precision(12);
+                          ss << jsonDirRoot;
+        auto after = steady_clock::now();
+        auto encodeMs = duration_cast<std::chrono::milliseconds>(after - before).count();
+        jjText = ss.str();
+        before = steady_clock::now();
+        auto jj17doc = json::parse(ss);
+        after = steady_clock::now();
+        auto decodeMs = duration_cast<std::chrono::milliseconds>(after - before).count();
+        QVERIFY(std::holds_alternative<json::Object>(jj17doc));
+        qDebug() << "JJSON17 text. size :"<<jjText.size()<<"bytes, encode :"<<encodeMs<<"ms, decode :"<<decodeMs<<"ms";
+    }
+    //........................
+    //....... QT-way: текст и CBOR  ........
+    {
+        //тот же документ, что и у jjson17: обход QDir оставил бы другие записи при MAX_ELEMS_AT_LVL
+        auto jsonDirRoot = QJsonDocument::fromJson(QByteArray::fromStdString(jjText)).object();
+        QVERIFY(!jsonDirRoot.isEmpty());
+
+        auto before = steady_clock::now();
+        QByteArray text = QJsonDocument(jsonDirRoot).toJson(QJsonDocument::Compact);
+        auto after = steady_clock::now();
+        auto encodeMs = duration_cast<std::chrono::milliseconds>(after - before).count();
+        before = steady_clock::now();
+        auto textDoc = QJsonDocument::fromJson(text);
+        after = steady_clock::now();
+        auto decodeMs = duration_cast<std::chrono::milliseconds>(after - before).count();
+        QVERIFY(textDoc.isObject());
+        qDebug() << "QJSON text (compact). size :"<<text.size()<<"bytes, encode :"<<encodeMs<<"ms, decode :"<<decodeMs<<"ms";
+
+        before = steady_clock::now();
+        QByteArray cbor = QCborValue::fromJsonValue(jsonDirRoot).toCbor();
+        after = steady_clock::now();
+        encodeMs = duration_cast<std::chrono::milliseconds>(after - before).count();
+        before = steady_clock::now();
+        auto cborDoc = QCborValue::fromCbor(cbor);
+        after = steady_clock::now();
+        decodeMs = duration_cast<std::chrono::milliseconds>(after - before).count();
+        QVERIFY(cborDoc.isMap());
+        QCOMPARE(cborDoc.toJsonValue().toObject(),jsonDirRoot);
+        qDebug() << "QCBOR. size :"<<cbor.size()<<"bytes, encode :"<<encodeMs<<"ms, decode :"<<decodeMs<<"ms";
+        qDebug() << "CBOR vs compact text size"<<double(cbor.size())/text.size()<<"the less the best";
+        qDebug() << "CBOR vs jjson17 text size"<<double(cbor.size())/jjText.size()<<"the less the best";
+    }
+    #else
+    QSKIP("skip perfomance test");
+    #endif
+}
+
+void QJsonCompatibility::perf_9_fanout_copy()
+{
+    #ifdef PERFOMANCE_TEST
+    namespace json = jjson17;
+    namespace fs = std::filesystem;
+    using namespace std::chrono;
+
+    //QSKIP("ALREADY COMPLETE");
+
+    const int MAX_DEPTH = 20;
+    const int MAX_ELEMS_AT_LVL = 20;
+
+    fs::directory_entry stdDir(getBigDir<std::string>()+"/..");
+    QVERIFY(stdDir.exists());
+    json::Object jsonDirRoot = subScanFunc(stdDir,0,MAX_DEPTH,MAX_ELEMS_AT_LVL);
+    const auto expectedDepth = std::get<int64_t>(jsonDirRoot.at("Depth"));
+
+    //каждый поток получает свою копию документа и читает из неё поле
+    auto fanOut = [&](unsigned threads, auto&& makeCopy) {
+        std::atomic<unsigned> good{0};
+        auto before = steady_clock::now();
+        std::vector<std::thread> pool;
+        for(unsigned t = 0; t < threads; ++t)
+            pool.emplace_back([&]() {
+                auto doc = makeCopy();
+                if(std::get<int64_t>(doc->at("Depth"))==expectedDepth) good++;
+            });
+        for(auto& t : pool)
+            t.join();
+        auto after = steady_clock::now();
+        return std::make_pair(good.load(),duration_cast<std::chrono::milliseconds>(after - before).count());
+    };
+
+    //разделяемый неизменяемый документ: копия указателя O(1), чтение из нескольких потоков безопасно
+    auto shared = std::make_shared<const json::Object>(std::move(jsonDirRoot));
+
+    const unsigned maxThreads = std::max(1u,std::thread::hardware_concurrency());
+    for(unsigned threads : threadCounts(maxThreads))
+    {
+        auto [deepGood,deepMs] = fanOut(threads,[&]() { return std::make_unique<json::Object>(*shared); });
+        auto [sharedGood,sharedMs] = fanOut(threads,[&]() { return shared; });
+        QCOMPARE(deepGood,threads);
+        QCOMPARE(sharedGood,threads);
+        qDebug() << "threads"<<threads<<": deep copy"<<deepMs<<"ms, shared_ptr<const Object>"<<sharedMs<<"ms";
+    }
+    #else
+    QSKIP("skip perfomance test");
+    #endif
+}
+
+void QJsonCompatibility::parse_1_numbers()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+
+    QString dirpath  = scopeDirPath+"/parse_1_numbers";
+    QString filepath = dirpath+"/test_q.json";
+    QDir dir("./");
+         dir.mkpath(dirpath);
+         dir.cd(dirpath);
+    QJsonObject qjsobj;
+                qjsobj.insert("First"  ,1);
+                qjsobj.insert("Second" ,2);
+                qjsobj.insert("Third"  ,1.11);
+                qjsobj.insert("Forth"  ,-9);
+                qjsobj.insert("Fifth"  ,-0.625);
+                qjsobj.insert("Sixth"  ,0);
+                qjsobj.insert("Seventh",-2.125);
+    QJsonDocument qjsdoc(qjsobj);
+    QFile   f(filepath);
+            f.open(QIODevice::WriteOnly);
+            f.write(qjsdoc.toJson());
+            f.close();
+    ifstream infile;
+             infile.open(filepath.toStdString());
+    auto jj17doc = parse(infile);
+             infile.close();
+    QVERIFY(holds_alternative<Object>(jj17doc));
+    Object& jj17obj = get<Object>(jj17doc);
+    QCOMPARE(jj17obj.size(),7);
+    for(const auto& v : jj17obj)
+        qDebug() << QString::fromStdString(v.first) << v.second.index();
+    QVERIFY(holds_alternative<int64_t>(jj17obj["First"  ]));
+    QVERIFY(holds_alternative<int64_t>(jj17obj["Second" ]));
+    QVERIFY(holds_alternative<double >(jj17obj["Third"  ]));
+    QVERIFY(holds_alternative<int64_t>(jj17obj["Forth"  ]));
+    QVERIFY(holds_alternative<double >(jj17obj["Fifth"  ]));
+    QVERIFY(holds_alternative<int64_t>(jj17obj["Sixth"  ]));
+    QVERIFY(holds_alternative<double >(jj17obj["Seventh"]));
+    QCOMPARE(get<int64_t>(jj17obj["First"  ]),1);
+    QCOMPARE(get<int64_t>(jj17obj["Second" ]),2);
+    QCOMPARE(get<double >(jj17obj["Third"  ]),1.11);
+    QCOMPARE(get<int64_t>(jj17obj["Forth"  ]),-9);
+    QCOMPARE(get<double >(jj17obj["Fifth"  ]),-0.625);
+    QCOMPARE(get<int64_t>(jj17obj["Sixth"  ]),0);
+    QCOMPARE(get<double >(jj17obj["Seventh"]),-2.125);
+
+    QJsonArray qjsarr = { 3,4,2.55,-390,-0.078,0,-10.001 };
+    qjsdoc.setArray(qjsarr);
+    filepath = dirpath+"/test_q2.json";
+        f.setFileName(filepath);
+        f.open(QIODevice::WriteOnly);
+        f.write(qjsdoc.toJson());
+        f.close();
+    infile.open(filepath.toStdString());
+    jj17doc = parse(infile);
+    infile.close();
+    QVERIFY(holds_alternative<Array>(jj17doc));
+    Array& jj17arr = get<Array>(jj17doc);
+    QCOMPARE(jj17arr.size(),7);
+    QVERIFY(holds_alternative<int64_t>(jj17arr[0]));
+    QVERIFY(holds_alternative<int64_t>(jj17arr[1]));
+    QVERIFY(holds_alternative<double >(jj17arr[2]));
+    QVERIFY(holds_alternative<int64_t>(jj17arr[3]));
+    QVERIFY(holds_alternative<double >(jj17arr[4]));
+    QVERIFY(holds_alternative<int64_t>(jj17arr[5]));
+    QVERIFY(holds_alternative<double >(jj17arr[6]));
+    QCOMPARE(get<int64_t>(jj17arr[0]),3);
+    QCOMPARE(get<int64_t>(jj17arr[1]),4);
+    QCOMPARE(get<double >(jj17arr[2]),2.55);
+    QCOMPARE(get<int64_t>(jj17arr[3]),-390);
+    QCOMPARE(get<double >(jj17arr[4]),-0.078);
+    QCOMPARE(get<int64_t>(jj17arr[5]),0);
+    QCOMPARE(get<double >(jj17arr[6]),-10.001);
+
+
+    dir.removeRecursively();
+}
+
+void QJsonCompatibility::parse_2_numbers_self()
+{
+    using namespace std;
     using namespace jjson17;
     //QSKIP("ALREADY COMPLETE");
 
@@ -1210,7 +2248,7 @@ struct MixLatinNum {
         obj.insert({"extention",extention});
         jjson17::Array arr;
         for(int i=0;i<3;++i) arr.push_back(coefs[i]);
-        obj.insert({"coefs",arr});
+        obj.insert({"coefs",std::move(arr)});
         if(next) obj.insert({"next",*next});
         return obj;
     }
@@ -1234,7 +2272,6 @@ private:
         if(arr.size() != 3) throw out_of_range("Wrong len of json array.");
         for(int i=0; i < int(arr.size()); ++i)
             res->coefs[i] = arr[i];         //using more safe 'operator double()' conversion
-        jjson17::Object copyobj = obj;
         if(auto i = obj.find("next"); i!=obj.end()) {
              qDebug() << QString::fromStdString(res->name) << std::distance(obj.begin(),i)<<std::distance(i,obj.end())<<'/'<<obj.size();
              res->next = nextObj(get<Object>(i->second),results);
@@ -1307,6 +2344,455 @@ void QJsonCompatibility::parse_4_mix_latin_nums()
         QFAIL("UNDEF::EXCEPTION");
     }
 }
+void QJsonCompatibility::parse_5_roundtrip_self()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+    //фикстуры test_1 ... test_8: запись -> разбор -> запись должны давать побайтово одинаковый текст
+    Struct s1 {"SSS",-10};
+    Struct s2 {"GGG",-100,&s1};
+    vector<pair<string,Value>> fixtures = {
+        {"test_1_latin",    Object{{"Str1","Val1"},{"Jkds dkfd","    "},{"Josef","Nope__x8"}}},
+        {"test_2_reals",    Array{28942.42,37e10,1./3,1.7/1e10,1.25f,-0.5625f,0.375f}},
+        {"test_3_integers", Array{-28942,short(37e2),12345678ll<<10,
+                                  (unsigned short)(-4000),char(27),(unsigned char)(27),
+                                  char(-70),uint8_t(33),int8_t(-33)}},
+        {"test_4_mix_latin_nums", Object{
+                {"Katrin",Object{{"name","Katrin"},{"position","sniper"},{"salary",1250.7},{"age",3},{"newbi",false},{"subordinates",Array{"Fich","Bik"}}}},
+                {"Fich"  ,Object{{"name","Fich"},{"position","officer"},{"salary",1500.23},{"age",38},{"newbi",false},{"subordinates",nullptr}}},
+                {"Bik"   ,Object{{"name","Bik"},{"position","mascot"},{"salary",0.},{"age",50},{"newbi",true},{"subordinates",nullptr}}},
+                {"something",Array{33.3,10.2,111,4000,"bravo",nullptr}}}},
+        {"test_5_unicode_1", Object{
+                {"name","Русский текст"},{"position","正在發展這個協"},{"salary",-350.},{"age",10},{"newbi",true},
+                {"subordinates",Array{"點對點（Wi-Fi Peer-to-Peer）"," نوعية واحدة م","domésticas más","기술적 설명"}}}},
+        {"test_6_escapeseq_1", Array{u8"AAA\"BBB",u8"AAA\'BBB",u8"AAA\\BBB",u8"AAA/BBB",u8"AAA\bBBB",
+                                     u8"AAA\fBBB",u8"AAA\nBBB",u8"AAA\rBBB",u8"AAA\tBBB",u8"AAA\u2211BBB"}},
+        {"test_7_incaps_structures_1", Object{
+                {"Level2A",Object{{"Level3",Object{{"name","Alex"},{"Один",123},{"Два",77},{u8"\u2211",200}}},{"Jin",nullptr}}},
+                {"Level2B",Object{{"Cat",Array{33,37.8,nullptr,"fur"}},{"Flag",true}}}}},
+        {"test_8_to_string", asJsonObject(s2)}
+    };
+
+    for(const auto& [name,fixture] : fixtures)
+    {
+        string first = toText(fixture);
+        istringstream iss(first);
+        auto jj17doc = parse(iss);
+        QVERIFY2(jj17doc.index()==fixture.index(), name.data());
+        string second = toText(jj17doc);
+        QVERIFY2(first==second, name.data());
+    }
+}
+
+void QJsonCompatibility::parse_6_reals_exact()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+    //при max_digits10 запись+разбор должны восстанавливать double побитово (QCOMPARE сравнивает нечётко)
+    vector<double> vals = { 1./3, 1.7/1e10, 0.1, 0.2+0.1, 28942.42, 37e10, -2.125, 1e21, 123456789.123456789,
+                            numeric_limits<double>::max(), numeric_limits<double>::min(),
+                            numeric_limits<double>::denorm_min(), -numeric_limits<double>::epsilon() };
+    Array w_arr;
+    for(auto v : vals)
+        w_arr.push_back(v);
+
+    stringstream ss;
+                 ss.precision(numeric_limits<double>::max_digits10);
+                 ss << w_arr;
+    auto jj17doc = parse(ss);
+    QVERIFY(holds_alternative<Array>(jj17doc));
+    const Array& r_arr = get<Array>(jj17doc);
+    QCOMPARE(r_arr.size(),vals.size());
+    for(size_t i = 0; i < vals.size(); ++i) {
+        double back = r_arr[i];                 //целые значения (37e10) читаются как int64_t
+        QVERIFY2(back==vals[i], QString("index %1: %2 != %3").arg(i).arg(back,0,'g',17).arg(vals[i],0,'g',17).toLatin1());
+    }
+}
+
+void QJsonCompatibility::parse_7_numeric_arrays()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+    //однородные массивы чисел и массивы, которые становятся смешанными только в конце
+    const size_t N = 10000;
+    Array ints, reals, intsThenReal, realsThenString, matrix;
+    for(size_t i = 0; i < N; ++i) {
+        ints.push_back(int64_t(i*7)-5000);
+        reals.push_back(i*0.25-100.5);
+        intsThenReal.push_back(int64_t(i));
+        realsThenString.push_back(i+0.5);
+    }
+    intsThenReal.push_back(0.125);
+    realsThenString.push_back("tail");
+    for(int r = 0; r < 10; ++r)
+        matrix.push_back(Array{r,r+0.5,-r,nullptr});
+    Object w_obj {
+        {"ints"           ,ints},
+        {"reals"          ,reals},
+        {"intsThenReal"   ,intsThenReal},
+        {"realsThenString",realsThenString},
+        {"matrix"         ,matrix},
+        {"empty"          ,Array{}}
+    };
+
+    stringstream ss;
+                 ss.precision(12);
+                 ss << w_obj;
+    auto jj17doc = parse(ss);
+    QVERIFY(holds_alternative<Object>(jj17doc));
+    Object& r_obj = get<Object>(jj17doc);
+
+    const Array& r_ints  = get<Array>(r_obj.at("ints"));
+    const Array& r_reals = get<Array>(r_obj.at("reals"));
+    QCOMPARE(r_ints.size() ,N);
+    QCOMPARE(r_reals.size(),N);
+    for(size_t i = 0; i < N; ++i) {
+        QVERIFY(holds_alternative<int64_t>(r_ints[i]));
+        QCOMPARE(get<int64_t>(r_ints[i]),int64_t(i*7)-5000);
+        double real = r_reals[i];                   //целые значения (-100.5+0.25*i) пишутся без точки
+        QCOMPARE(real,i*0.25-100.5);
+    }
+
+    const Array& r_intsThenReal = get<Array>(r_obj.at("intsThenReal"));
+    QCOMPARE(r_intsThenReal.size(),N+1);
+    QVERIFY(holds_alternative<int64_t>(r_intsThenReal[N-1]));
+    QVERIFY(holds_alternative<double >(r_intsThenReal[N]));
+    QCOMPARE(get<double>(r_intsThenReal[N]),0.125);
+
+    const Array& r_realsThenString = get<Array>(r_obj.at("realsThenString"));
+    QCOMPARE(r_realsThenString.size(),N+1);
+    QVERIFY(holds_alternative<double>(r_realsThenString[N-1]));
+    QVERIFY(holds_alternative<string>(r_realsThenString[N]));
+    QCOMPARE(get<string>(r_realsThenString[N]),string("tail"));
+
+    const Array& r_matrix = get<Array>(r_obj.at("matrix"));
+    QCOMPARE(r_matrix.size(),size_t(10));
+    QCOMPARE(r_matrix,matrix);
+
+    QVERIFY(get<Array>(r_obj.at("empty")).empty());
+}
+
+//RFC 6901 JSON Pointer over a parsed document, nullptr if the pointer does not resolve.
+//~1 и ~0 раскрываются по одному символу, поэтому "~01" даёт "~1", а не "/"
+static const jjson17::Value* evalPointer(const jjson17::Value& root, const std::string& pointer)
+{
+    namespace json = jjson17;
+    if(pointer.empty()) return &root;
+    if(pointer[0] != '/') return nullptr;
+    const json::Value* cur = &root;
+    size_t pos = 1;
+    for(;;) {
+        const size_t end = std::min(pointer.find('/',pos),pointer.size());
+        std::string token;
+        for(size_t i = pos; i < end; ++i) {
+            if(pointer[i] != '~') { token += pointer[i]; continue; }
+            if(++i == end) return nullptr;
+            if(pointer[i] == '0')      token += '~';
+            else if(pointer[i] == '1') token += '/';
+            else return nullptr;
+        }
+        if(std::holds_alternative<json::Object>(*cur)) {
+            const auto& obj = std::get<json::Object>(*cur);
+            auto it = obj.find(token);
+            if(it == obj.end()) return nullptr;
+            cur = &it->second;
+        }
+        else if(std::holds_alternative<json::Array>(*cur)) {
+            //индекс массива: десятичное число без ведущих нулей ("-" указывает за конец и не разрешается)
+            const auto& arr = std::get<json::Array>(*cur);
+            if(token.empty() || token.size() > 9 || (token.size() > 1 && token[0] == '0')
+               || token.find_first_not_of("0123456789") != std::string::npos) return nullptr;
+            const size_t idx = std::stoul(token);
+            if(idx >= arr.size()) return nullptr;
+            cur = &arr[idx];
+        }
+        else return nullptr;
+        if(end == pointer.size()) return cur;
+        pos = end+1;
+    }
+}
+
+void QJsonCompatibility::parse_8_rfc6901_keys()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+    //документ-пример из RFC 6901 (JSON Pointer): ключи со спецсимволами должны читаться как есть
+    const string rfcDoc = R"({
+        "foo": ["bar", "baz"],
+        "": 0,
+        "a/b": 1,
+        "c%d": 2,
+        "e^f": 3,
+        "g|h": 4,
+        "i\\j": 5,
+        "k\"l": 6,
+        " ": 7,
+        "m~n": 8
+    })";
+    istringstream iss(rfcDoc);
+    auto jj17doc = parse(iss);
+    QVERIFY(holds_alternative<Object>(jj17doc));
+    const Object& obj = get<Object>(jj17doc);
+    QCOMPARE(obj.size(),size_t(10));
+
+    const Array& foo = get<Array>(obj.at("foo"));
+    QCOMPARE(foo.size(),size_t(2));
+    QCOMPARE(get<string>(foo[0]),string("bar"));
+    QCOMPARE(get<string>(foo[1]),string("baz"));
+
+    const vector<pair<string,int64_t>> keys = {
+        {"",0},{"a/b",1},{"c%d",2},{"e^f",3},{"g|h",4},{"i\\j",5},{"k\"l",6},{" ",7},{"m~n",8}
+    };
+    for(const auto& [k,v] : keys) {
+        QVERIFY2(obj.find(k)!=obj.end(), k.data());
+        QCOMPARE(get<int64_t>(obj.at(k)),v);
+    }
+
+    //таблица указатель -> значение из раздела 5 RFC 6901
+    QVERIFY(evalPointer(jj17doc,"")==&jj17doc);
+    const vector<pair<string,Value>> pointers = {
+        {"/foo"  ,Array{"bar","baz"}},
+        {"/foo/0","bar"},
+        {"/"     ,0},
+        {"/a~1b" ,1},
+        {"/c%d"  ,2},
+        {"/e^f"  ,3},
+        {"/g|h"  ,4},
+        {"/i\\j" ,5},
+        {"/k\"l" ,6},
+        {"/ "    ,7},
+        {"/m~0n" ,8}
+    };
+    for(const auto& [pointer,expected] : pointers) {
+        const Value* got = evalPointer(jj17doc,pointer);
+        QVERIFY2(got && *got==expected, pointer.data());
+    }
+    //и указатели, которые не должны разрешаться
+    for(const string pointer : {"foo","/foo/2","/foo/01","/foo/-","/foo/0/x","/a/b","/a~2b","/m~","/missing"})
+        QVERIFY2(evalPointer(jj17doc,pointer)==nullptr, pointer.data());
+
+    //и те же ключи переживают запись обратно
+    stringstream ss;
+                 ss << obj;
+    auto back = parse(ss);
+    QVERIFY(holds_alternative<Object>(back));
+    QCOMPARE(get<Object>(back),obj);
+}
+
+void QJsonCompatibility::parse_9_shape_errors()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+    //синтаксически верные сообщения с неверной формой: проверка формы сейчас делается вручную в MixLatinNum::nextObj
+    enum class Expect { Ok, OutOfRange, BadVariant };
+    const vector<tuple<string,string,Expect>> messages = {
+        {"valid"         , R"({"name":"Alpha","depth":0,"extention":false,"coefs":[0,6.4,66.38]})"                , Expect::Ok},
+        {"nested valid"  , R"({"name":"Beta","depth":0,"extention":true,"coefs":[0.1,0.2,0.3],)"
+                           R"("next":{"name":"Kappa","depth":1,"extention":false,"coefs":[11,22,33]}})"           , Expect::Ok},
+        {"short coefs"   , R"({"name":"Alpha","depth":0,"extention":false,"coefs":[0,6.4]})"                      , Expect::OutOfRange},
+        {"missing name"  , R"({"depth":0,"extention":false,"coefs":[0,6.4,66.38]})"                               , Expect::OutOfRange},
+        {"string depth"  , R"({"name":"Alpha","depth":"0","extention":false,"coefs":[0,6.4,66.38]})"              , Expect::BadVariant},
+        {"real depth"    , R"({"name":"Alpha","depth":0.5,"extention":false,"coefs":[0,6.4,66.38]})"              , Expect::BadVariant},
+        {"coefs object"  , R"({"name":"Alpha","depth":0,"extention":false,"coefs":{"a":1}})"                      , Expect::BadVariant},
+        {"bad next"      , R"({"name":"Alpha","depth":0,"extention":false,"coefs":[0,6.4,66.38],"next":[1]})"     , Expect::BadVariant},
+        {"deep bad next" , R"({"name":"Beta","depth":0,"extention":true,"coefs":[0.1,0.2,0.3],)"
+                           R"("next":{"name":"Kappa","depth":1,"extention":false,"coefs":[11,22]}})"              , Expect::OutOfRange}
+    };
+
+    for(const auto& [name,text,expect] : messages)
+    {
+        istringstream iss(text);
+        auto jj17doc = parse(iss);
+        QVERIFY2(holds_alternative<Object>(jj17doc), name.data());
+        Expect got{Expect::Ok};
+        try {
+            MixLatinNum::from(get<Object>(jj17doc));
+        } catch(const out_of_range&) {
+            got = Expect::OutOfRange;
+        } catch(const bad_variant_access&) {
+            got = Expect::BadVariant;
+        }
+        QVERIFY2(got==expect, name.data());
+    }
+}
+
+//streambuf that hands its data out in chunks cut at the given offsets
+class ChunkedBuf : public std::streambuf
+{
+public:
+    ChunkedBuf(const std::string& data, std::vector<size_t> cuts)
+        : data_(data), cuts_(std::move(cuts)) {}
+protected:
+    int_type underflow() override
+    {
+        if(gptr() < egptr()) return traits_type::to_int_type(*gptr());
+        if(pos_ >= data_.size()) return traits_type::eof();
+        size_t end = data_.size();
+        for(auto c : cuts_)
+            if(c > pos_) { end = std::min(end,c); break; }
+        chunk_.assign(data_,pos_,end-pos_);          //копия: байты прошлого куска больше не доступны
+        pos_ = end;
+        setg(chunk_.data(),chunk_.data(),chunk_.data()+chunk_.size());
+        return traits_type::to_int_type(*gptr());
+    }
+private:
+    const std::string&  data_;
+    std::vector<size_t> cuts_;
+    std::string         chunk_;
+    size_t              pos_{0};
+};
+
+void QJsonCompatibility::parse_10_chunked_input()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+    //фикстуры parse_*: разбор не должен зависеть от того, где поток разрезан на куски
+    vector<pair<string,string>> fixtures;
+    {
+        QJsonObject qjsobj{{"First",1},{"Second",2},{"Third",1.11},{"Forth",-9},{"Fifth",-0.625},{"Sixth",0},{"Seventh",-2.125}};
+        fixtures.push_back({"parse_1 object",QJsonDocument(qjsobj).toJson().toStdString()});
+        QJsonArray qjsarr = { 3,4,2.55,-390,-0.078,0,-10.001 };
+        fixtures.push_back({"parse_1 array",QJsonDocument(qjsarr).toJson().toStdString()});
+    }
+    {
+        QStringList testList = {"1","null","abracadabra","Jerom K."," Helicopter \"K52\"","moonlight\nsunlight","good morning, little mouse!","object{N}",""};
+        QJsonArray qjsarr;
+        foreach (const auto& s, testList)
+            qjsarr.append(s);
+        fixtures.push_back({"parse_3 array",QJsonDocument(qjsarr).toJson().toStdString()});
+    }
+    {
+        vector<MixLatinNum> dep1vec={{"Kappa",1,{11.,22.,33.}},
+                                     {"Omega",1,{8.,8.,8.},nullptr,true}};
+        vector<MixLatinNum> dep0vec={{"Alpha",0,{0.,6.4,66.38}},
+                                     {"Beta",0,{0.1,0.2,0.3},&dep1vec[0],true},
+                                     {"Gamma",0,{0.,9.01,0.},&dep1vec[1]}};
+        QJsonArray qjsarr;
+        for(auto& m : dep0vec)
+            qjsarr.append(m);
+        fixtures.push_back({"parse_4 array",QJsonDocument(qjsarr).toJson().toStdString()});
+    }
+    {
+        Array w_arr{u8"AAA\"BBB",u8"AAA\\BBB",u8"AAA/BBB",u8"AAA\bBBB",u8"AAA\fBBB",
+                    u8"AAA\nBBB",u8"AAA\rBBB",u8"AAA\tBBB",u8"AAA∑BBB","Русский текст","기술적 설명"};
+        stringstream ss;
+                     ss << w_arr;
+        fixtures.push_back({"escapes and unicode",ss.str()});
+    }
+
+    for(const auto& [name,text] : fixtures)
+    {
+        istringstream whole(text);
+        const string etalon = toText(parse(whole));
+
+        vector<size_t> everyByte;
+        for(size_t cut = 1; cut < text.size(); ++cut)
+        {
+            everyByte.push_back(cut);
+            ChunkedBuf buf(text,{cut});
+            istream in(&buf);
+            QVERIFY2(toText(parse(in))==etalon, QString("%1, cut at %2").arg(QString::fromStdString(name)).arg(cut).toLatin1());
+        }
+        ChunkedBuf buf(text,everyByte);
+        istream in(&buf);
+        QVERIFY2(toText(parse(in))==etalon, QString("%1, byte by byte").arg(QString::fromStdString(name)).toLatin1());
+    }
+}
+
+void QJsonCompatibility::parse_11_unicode_escapes()
+{
+    using namespace std;
+    using namespace jjson17;
+
+    //QSKIP("ALREADY COMPLETE");
+    //\uXXXX на входе: BMP, суррогатные пары, регистр hex, соседство с другими escape-последовательностями
+    const string text = R"([
+        "\u0041bc",
+        "\u00e9\u00C9",
+        "AAA\u2211BBB",
+        "\u4e2d\u6587",
+        "\ud83d\ude00",
+        "x\uD834\uDD1Ey",
+        "\"\\\/\b\f\n\r\t",
+        "\u0000end",
+        "Русский \uae30\uc220\uc801 \ud83d\ude00"
+    ])";
+    const vector<string> expected = {
+        "Abc",
+        u8"éÉ",
+        u8"AAA∑BBB",
+        u8"中文",
+        u8"\U0001F600",
+        u8"x\U0001D11Ey",
+        "\"\\/\b\f\n\r\t",
+        string("\0end",4),
+        u8"Русский 기술적 \U0001F600"
+    };
+    istringstream iss(text);
+    auto jj17doc = parse(iss);
+    QVERIFY(holds_alternative<Array>(jj17doc));
+    const Array& r_arr = get<Array>(jj17doc);
+    QCOMPARE(r_arr.size(),expected.size());
+    for(size_t i = 0; i < expected.size(); ++i)
+        QVERIFY2(get<string>(r_arr[i])==expected[i], QString("index %1").arg(i).toLatin1());
+
+    //неверный вход отвергается исключением: одиночные суррогаты, обрезанный \u, overlong и битый UTF-8.
+    //проверка суррогатов и UTF-8 в ../jjson17 не подтверждена запуском, поэтому эти случаи помечены ожидаемым отказом
+    const vector<tuple<string,string,bool>> invalid = {
+        {"lone high surrogate", R"(["\ud83d"])"      , true },
+        {"lone low surrogate" , R"(["\ude00x"])"     , true },
+        {"truncated escape"   , R"(["\u12"])"        , false},
+        {"overlong utf-8"     , "[\"\xC0\xAF\"]"     , true },
+        {"bad continuation"   , "[\"\xC3\x28\"]"     , true }
+    };
+    for(const auto& [name,bad,pending] : invalid)
+    {
+        istringstream in(bad);
+        bool goodException{false};
+        try{ auto doc = parse(in); Q_UNUSED(doc); } catch(const exception& e) {goodException=true;}
+        if(pending)
+            QEXPECT_FAIL("", "UTF-8 and surrogate validation is not confirmed in jjson17 yet", Continue);
+        QVERIFY2(goodException, name.data());
+    }
+
+    //на выходе: текст должен оставаться корректным JSON
+    Array w_arr;
+    for(const auto& e : expected)
+        if(e.find('\0')==string::npos)
+            w_arr.push_back(e);
+    stringstream ss;
+                 ss << w_arr;
+    auto doc = QJsonDocument::fromJson(QByteArray::fromStdString(ss.str()));
+    QVERIFY(doc.isArray());
+    auto q_arr = doc.array();
+    QCOMPARE(size_t(q_arr.size()),w_arr.size());
+    for(size_t i = 0; i < w_arr.size(); ++i)
+        QVERIFY2(q_arr[int(i)].toString().toStdString()==get<string>(w_arr[i]), QString("written index %1").arg(i).toLatin1());
+
+    //управляющие символы без короткой записи должны писаться как \u0000..\u001f; в писателе это не подтверждено
+    Array w_ctrl{string("\0end",4),string("\x01\x1f\x7f",3)};
+    stringstream cs;
+                 cs << w_ctrl;
+    auto ctrlDoc = QJsonDocument::fromJson(QByteArray::fromStdString(cs.str()));
+    bool ctrlGood = ctrlDoc.isArray() && size_t(ctrlDoc.array().size())==w_ctrl.size();
+    for(size_t i = 0; ctrlGood && i < w_ctrl.size(); ++i)
+        ctrlGood = ctrlDoc.array()[int(i)].toString().toStdString()==get<string>(w_ctrl[i]);
+    QEXPECT_FAIL("", "control characters are not confirmed to be \\u-escaped by the jjson17 writer yet", Continue);
+    QVERIFY(ctrlGood);
+}
+
 QTEST_APPLESS_MAIN(QJsonCompatibility)
 
 #include "tst_qjsoncompatibility.moc"